@@ -0,0 +1,274 @@
+/*
+ * ===================================================================
+ * LOAD GENERATOR for the sorted-array server mode
+ *
+ * Start the server first:
+ *   g++ -O2 optimized_binary_search.cpp -o server
+ *   ./server --serve unix:/tmp/students.sock
+ *
+ * Then run:
+ *   g++ -O2 load_generator.cpp -o loadgen
+ *   ./loadgen unix:/tmp/students.sock [students] [requests] [pipeline] [connections]
+ *
+ * Each connection first adds its share of students, waits until every
+ * connection has done so, then sends FIND requests for random existing
+ * IDs, keeping <pipeline> requests in flight, and finally one SETMARKS
+ * per student it added.
+ * ===================================================================
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/*
+ * -------------------------------------------------------------------
+ * Connection: a blocking socket that sends a batch of request lines
+ * and reads back exactly as many reply lines.
+ * -------------------------------------------------------------------
+ */
+class Connection {
+private:
+    int m_fd = -1;
+    std::string m_pending; // reply bytes read past the last full line
+
+public:
+    bool open(const std::string& address) {
+        if (address.rfind("unix:", 0) == 0) {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, address.c_str() + 5, sizeof(addr.sun_path) - 1);
+            m_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            return m_fd != -1 && connect(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        }
+        if (address.rfind("tcp:", 0) == 0) {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(std::atoi(address.c_str() + 4)));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            m_fd = socket(AF_INET, SOCK_STREAM, 0);
+            int yes = 1;
+            if (m_fd != -1) setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            return m_fd != -1 && connect(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        }
+        return false;
+    }
+
+    ~Connection() {
+        if (m_fd != -1) close(m_fd);
+    }
+
+    // Send all request lines in one write, then collect one reply per line.
+    // Returns how many replies started with "OK".
+    int roundTrip(const std::string& batch, int requests) {
+        size_t sent = 0;
+        while (sent < batch.size()) {
+            ssize_t n = send(m_fd, batch.data() + sent, batch.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                if (n == -1 && errno == EINTR) continue;
+                return -1;
+            }
+            sent += static_cast<size_t>(n);
+        }
+
+        int ok = 0;
+        int replies = 0;
+        char buffer[64 * 1024];
+        while (replies < requests) {
+            size_t start = 0;
+            size_t end;
+            while (replies < requests && (end = m_pending.find('\n', start)) != std::string::npos) {
+                if (m_pending.compare(start, 2, "OK") == 0) ok++;
+                replies++;
+                start = end + 1;
+            }
+            m_pending.erase(0, start);
+            if (replies == requests) break;
+
+            ssize_t n = recv(m_fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                if (n == -1 && errno == EINTR) continue;
+                return -1;
+            }
+            m_pending.append(buffer, static_cast<size_t>(n));
+        }
+        return ok;
+    }
+};
+
+/*
+ * -------------------------------------------------------------------
+ * StartLatch: holds every worker back until all of them have arrived,
+ * so no FIND is sent for an ID another connection has not added yet.
+ * -------------------------------------------------------------------
+ */
+class StartLatch {
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_allArrived;
+    int m_remaining;
+
+public:
+    explicit StartLatch(int count) : m_remaining(count) {}
+
+    void arriveAndWait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (--m_remaining == 0) {
+            m_allArrived.notify_all();
+            return;
+        }
+        m_allArrived.wait(lock, [this] { return m_remaining == 0; });
+    }
+};
+
+/*
+ * -------------------------------------------------------------------
+ * Per-connection workload and results
+ * -------------------------------------------------------------------
+ */
+struct WorkerResult {
+    long requests = 0;
+    long okReplies = 0;
+    bool failed = false;
+};
+
+void runWorker(const std::string& address, int firstId, int studentCount, int totalStudents,
+               long findRequests, int pipeline, StartLatch& phase1Done, WorkerResult& result) {
+    Connection conn;
+    if (!conn.open(address)) {
+        result.failed = true;
+        phase1Done.arriveAndWait(); // the others still wait for this worker
+        return;
+    }
+
+    auto send = [&](const std::string& batch, int count) {
+        int ok = conn.roundTrip(batch, count);
+        if (ok < 0) {
+            result.failed = true;
+            return false;
+        }
+        result.requests += count;
+        result.okReplies += ok;
+        return true;
+    };
+
+    // Phase 1: register this connection's students
+    std::string batch;
+    int inBatch = 0;
+    bool added = true;
+    for (int i = 0; i < studentCount && added; ++i) {
+        int id = firstId + i;
+        batch += "ADD " + std::to_string(id) + "|Student " + std::to_string(id) +
+                 "|Computer Science|Algorithms;Databases;Networks\n";
+        if (++inBatch == pipeline) {
+            added = send(batch, inBatch);
+            batch.clear();
+            inBatch = 0;
+        }
+    }
+    if (added && inBatch > 0) added = send(batch, inBatch);
+    batch.clear();
+    inBatch = 0;
+
+    // Every connection must arrive, even a failed one, or the rest hang
+    phase1Done.arriveAndWait();
+    if (!added) return;
+
+    // Phase 2: random lookups across all students
+    std::mt19937 rng(static_cast<unsigned>(firstId) + 1);
+    std::uniform_int_distribution<int> pick(1, totalStudents);
+    for (long i = 0; i < findRequests; ++i) {
+        batch += "FIND " + std::to_string(pick(rng)) + "\n";
+        if (++inBatch == pipeline) {
+            if (!send(batch, inBatch)) return;
+            batch.clear();
+            inBatch = 0;
+        }
+    }
+    if (inBatch > 0 && !send(batch, inBatch)) return;
+    batch.clear();
+    inBatch = 0;
+
+    // Phase 3: one mark update per student
+    for (int i = 0; i < studentCount; ++i) {
+        batch += "SETMARKS " + std::to_string(firstId + i) + " 70 80 90\n";
+        if (++inBatch == pipeline) {
+            if (!send(batch, inBatch)) return;
+            batch.clear();
+            inBatch = 0;
+        }
+    }
+    if (inBatch > 0) send(batch, inBatch);
+}
+
+/*
+ * -------------------------------------------------------------------
+ * main()
+ * -------------------------------------------------------------------
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0]
+                  << " unix:<path>|tcp:<port> [students] [requests] [pipeline] [connections]\n";
+        return 1;
+    }
+
+    std::string address = argv[1];
+    int students = argc > 2 ? std::atoi(argv[2]) : 10000;
+    long requests = argc > 3 ? std::atol(argv[3]) : 1000000;
+    int pipeline = argc > 4 ? std::atoi(argv[4]) : 64;
+    int connections = argc > 5 ? std::atoi(argv[5]) : 4;
+    if (students < 1 || requests < 0 || pipeline < 1 || connections < 1) {
+        std::cout << "All counts must be positive.\n";
+        return 1;
+    }
+
+    std::vector<WorkerResult> results(connections);
+    std::vector<std::thread> workers;
+    StartLatch phase1Done(connections);
+    int perConnection = students / connections;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < connections; ++c) {
+        int first = 1 + c * perConnection;
+        int count = (c == connections - 1) ? students - c * perConnection : perConnection;
+        workers.emplace_back(runWorker, address, first, count, students,
+                             requests / connections, pipeline, std::ref(phase1Done), std::ref(results[c]));
+    }
+    for (std::thread& t : workers) t.join();
+    auto end = std::chrono::steady_clock::now();
+
+    long total = 0;
+    long ok = 0;
+    bool failed = false;
+    for (const WorkerResult& r : results) {
+        total += r.requests;
+        ok += r.okReplies;
+        failed = failed || r.failed;
+    }
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "Requests : " << total << " (" << ok << " OK)\n";
+    std::cout << "Time     : " << seconds << " s\n";
+    std::cout << "Rate     : " << static_cast<long>(total / seconds) << " requests/s\n";
+    if (failed) {
+        std::cout << "Some connections failed; is the server running on " << address << "?\n";
+        return 1;
+    }
+    return 0;
+}
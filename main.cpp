@@ -10,6 +10,15 @@
  * - Search is a Linear Search (O(n)).
  * 2. Optimized: Stores students in a Binary Search Tree (BST).
  * - Search is a Binary Search (O(log n)).
+ * 3. Sharded: Splits students across N engines by ID, each engine
+ * owned by its own thread and fed through a request queue.
+ * 4. Adaptive: Appends writes to a log and folds them into a sorted
+ * array in the background once reads start to dominate.
+ * 5. Memory: Reports how many bytes each engine really uses, split
+ * into payload, index, overhead and slack.
+ * 6. Latency: Every engine operation is timed into per-thread
+ * histograms; the slowest ones are kept with their ID and steps.
+ * Run with --trace=<file> to also write them as a Chrome trace.
  * ===================================================================
  */
 
@@ -18,6 +27,22 @@
 #include <vector> // For the Baseline solution
 #include <chrono> // For timing
 #include <memory> // For smart pointers (in BST)
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <random>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <iomanip>
+#include <cstdint>
+#include <malloc.h>  // malloc_usable_size, for real heap block sizes
 
 /*
  * -------------------------------------------------------------------
@@ -40,6 +65,428 @@ struct Student {
     }
 };
 
+/*
+ * -------------------------------------------------------------------
+ * HEAP TRACKING
+ * Every operator new/delete in the program is counted at the size the
+ * allocator really hands out, so the structure walks below can be
+ * checked against what was actually taken from the heap.
+ * -------------------------------------------------------------------
+ */
+const size_t MALLOC_CHUNK_HEADER = sizeof(size_t); // glibc keeps the block size in front
+
+std::atomic<long long> g_heapBytes{0};
+std::atomic<long long> g_heapBlocks{0};
+
+// Bytes a heap block really occupies (usable size plus the allocator header)
+size_t heapBlockBytes(const void* p) {
+    return malloc_usable_size(const_cast<void*>(p)) + MALLOC_CHUNK_HEADER;
+}
+
+void* operator new(size_t size) {
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    g_heapBytes.fetch_add(static_cast<long long>(heapBlockBytes(p)), std::memory_order_relaxed);
+    g_heapBlocks.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p == nullptr) {
+        return;
+    }
+    g_heapBytes.fetch_sub(static_cast<long long>(heapBlockBytes(p)), std::memory_order_relaxed);
+    g_heapBlocks.fetch_sub(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+/*
+ * -------------------------------------------------------------------
+ * MEMORY REPORT
+ * Where an engine's bytes go. Every byte is in exactly one category:
+ * - payload:  the data itself (ID, name characters, marks)
+ * - index:    bytes that only exist to find students (tree links)
+ * - slack:    reserved but unused (spare capacity, allocator rounding)
+ * - overhead: the rest (object headers, padding, allocator headers)
+ * -------------------------------------------------------------------
+ */
+struct MemoryReport {
+    size_t students = 0;
+    size_t total = 0;
+    size_t payload = 0;
+    size_t index = 0;
+    size_t slack = 0;
+
+    size_t overhead() const { return total - payload - index - slack; }
+
+    void add(const MemoryReport& other) {
+        students += other.students;
+        total += other.total;
+        payload += other.payload;
+        index += other.index;
+        slack += other.slack;
+    }
+
+    void print() const {
+        auto line = [this](const char* label, size_t bytes) {
+            std::cout << "  " << label << bytes << " bytes";
+            if (total > 0) {
+                std::cout << " (" << 100.0 * bytes / total << "%)";
+            }
+            std::cout << "\n";
+        };
+        std::cout << "  Students: " << students << "\n";
+        std::cout << "  Total:    " << total << " bytes";
+        if (students > 0) {
+            std::cout << ", " << static_cast<double>(total) / students << " per student";
+        }
+        std::cout << "\n";
+        line("Payload:  ", payload);
+        line("Index:    ", index);
+        line("Overhead: ", overhead());
+        line("Slack:    ", slack);
+    }
+};
+
+// Payload and string slack of one student; the Student object itself is
+// counted by whoever holds it.
+void accountStudent(MemoryReport& report, const Student& s) {
+    report.students++;
+    report.payload += sizeof(s.id) + sizeof(s.marks) + s.name.size();
+    report.slack += s.name.capacity() - s.name.size();
+
+    const char* text = s.name.data();
+    const char* object = reinterpret_cast<const char*>(&s.name);
+    if (text < object || text >= object + sizeof(s.name)) {
+        // Too long for the small-string buffer: a separate heap block
+        size_t block = heapBlockBytes(text);
+        report.total += block;
+        report.slack += block - MALLOC_CHUNK_HEADER - (s.name.capacity() + 1);
+    }
+}
+
+/*
+ * -------------------------------------------------------------------
+ * LATENCY FLIGHT RECORDER
+ * Every add, find and marks update is timed, always. Each thread
+ * records into histograms of its own, so recording takes no locks;
+ * a report merges the threads' histograms when it is asked for. The
+ * histograms are HDR-style: exact below 64 ns, then 32 buckets per
+ * power of two, so every latency is kept to within about 3%.
+ * Each thread also keeps its slowest operations with the student ID
+ * and step count, for a text report or a Chrome trace file (open in
+ * chrome://tracing or ui.perfetto.dev). Sharded engines record on
+ * their owner threads.
+ * -------------------------------------------------------------------
+ */
+enum class Operation { Add, Find, SetMarks };
+const int OPERATION_COUNT = 3;
+
+const char* operationName(Operation op) {
+    switch (op) {
+        case Operation::Add: return "add";
+        case Operation::Find: return "find";
+        case Operation::SetMarks: return "set-marks";
+    }
+    return "?";
+}
+
+// Counts of one or more histograms, added up for reporting
+struct LatencySummary {
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+
+    double meanNs() const { return count == 0 ? 0.0 : static_cast<double>(totalNs) / count; }
+
+    // Latency that a fraction q of operations did not exceed
+    uint64_t percentile(double q) const;
+};
+
+class LatencyHistogram {
+public:
+    static const int EXACT = 64;        // one bucket per nanosecond below this
+    static const int SUB_BUCKETS = 32;  // per power of two above it
+    static const int MAX_SHIFT = 34;    // up to 2^40 ns (18 minutes); longer goes in the last bucket
+    static const int BUCKETS = EXACT + MAX_SHIFT * SUB_BUCKETS;
+
+    static int bucketFor(uint64_t ns) {
+        if (ns < EXACT) {
+            return static_cast<int>(ns);
+        }
+        int msb = 63 - __builtin_clzll(ns);
+        int shift = msb - 5; // keep the top 6 bits: 32 sub-buckets
+        if (shift > MAX_SHIFT) {
+            return BUCKETS - 1;
+        }
+        return EXACT + (shift - 1) * SUB_BUCKETS + static_cast<int>(ns >> shift) - SUB_BUCKETS;
+    }
+
+    // Largest latency that falls in the bucket
+    static uint64_t bucketTop(int bucket) {
+        if (bucket < EXACT) {
+            return bucket;
+        }
+        int shift = (bucket - EXACT) / SUB_BUCKETS + 1;
+        uint64_t top = (bucket - EXACT) % SUB_BUCKETS + SUB_BUCKETS;
+        return ((top + 1) << shift) - 1;
+    }
+
+    // Owner thread only. With a single writer a plain load and store is
+    // enough; the atomics only let reports read while it records.
+    void record(uint64_t ns) {
+        bump(m_counts[bucketFor(ns)], 1);
+        bump(m_count, 1);
+        bump(m_totalNs, ns);
+        if (ns > m_maxNs.load(std::memory_order_relaxed)) {
+            m_maxNs.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread
+    void addTo(LatencySummary& summary) const {
+        summary.counts.resize(BUCKETS, 0);
+        for (int i = 0; i < BUCKETS; ++i) {
+            summary.counts[i] += m_counts[i].load(std::memory_order_relaxed);
+        }
+        summary.count += m_count.load(std::memory_order_relaxed);
+        summary.totalNs += m_totalNs.load(std::memory_order_relaxed);
+        summary.maxNs = std::max(summary.maxNs, m_maxNs.load(std::memory_order_relaxed));
+    }
+
+    // Only while the owner thread is not recording
+    void reset() {
+        for (auto& c : m_counts) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_totalNs.store(0, std::memory_order_relaxed);
+        m_maxNs.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t by) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> m_counts[BUCKETS] = {};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_totalNs{0};
+    std::atomic<uint64_t> m_maxNs{0};
+};
+
+uint64_t LatencySummary::percentile(double q) const {
+    uint64_t rank = static_cast<uint64_t>(q * count + 0.5);
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(LatencyHistogram::bucketTop(static_cast<int>(i)), maxNs);
+        }
+    }
+    return maxNs;
+}
+
+// One operation slow enough to be kept
+struct SlowOperation {
+    Operation op;
+    int id;
+    int steps;
+    uint64_t startNs;    // since the recorder was last reset
+    uint64_t durationNs;
+    int thread;          // recorder's own thread number
+};
+
+class FlightRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+    static const size_t SLOW_CAPACITY = 16; // slowest operations kept per thread
+
+    FlightRecorder() : m_startNs(Clock::now().time_since_epoch().count()) {}
+
+    void record(Operation op, int id, int steps, Clock::time_point start, Clock::time_point end) {
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        ThreadLog& log = local();
+        log.histograms[static_cast<int>(op)].record(ns);
+        if (ns <= log.slowThreshold.load(std::memory_order_relaxed)) {
+            return; // the common case: not among this thread's slowest
+        }
+
+        std::lock_guard<std::mutex> lock(log.slowLock);
+        long long started = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count()
+                            - m_startNs.load(std::memory_order_relaxed);
+        SlowOperation entry{op, id, steps, static_cast<uint64_t>(std::max(0LL, started)), ns, log.thread};
+        if (log.slowest.size() < SLOW_CAPACITY) {
+            log.slowest.push_back(entry);
+            if (log.slowest.size() < SLOW_CAPACITY) {
+                return;
+            }
+        } else {
+            *fastestSlow(log) = entry;
+        }
+        log.slowThreshold.store(fastestSlow(log)->durationNs, std::memory_order_relaxed);
+    }
+
+    // Forget everything recorded so far. Call only while no thread is
+    // running an operation.
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto& log : m_threads) {
+            for (auto& h : log->histograms) {
+                h.reset();
+            }
+            std::lock_guard<std::mutex> slowLock(log->slowLock);
+            log->slowest.clear();
+            log->slowThreshold.store(0, std::memory_order_relaxed);
+        }
+        m_startNs.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    // Histograms of every thread for one operation, merged
+    LatencySummary summary(Operation op) {
+        LatencySummary total;
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto& log : m_threads) {
+            log->histograms[static_cast<int>(op)].addTo(total);
+        }
+        return total;
+    }
+
+    // Slowest operations kept by every thread, slowest first
+    std::vector<SlowOperation> slowest() {
+        std::vector<SlowOperation> all;
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto& log : m_threads) {
+            std::lock_guard<std::mutex> slowLock(log->slowLock);
+            all.insert(all.end(), log->slowest.begin(), log->slowest.end());
+        }
+        std::sort(all.begin(), all.end(),
+                  [](const SlowOperation& a, const SlowOperation& b) { return a.durationNs > b.durationNs; });
+        return all;
+    }
+
+    // Percentiles per operation, then the top slowest operations
+    void printReport(std::ostream& out, size_t top = 10) {
+        out << "  " << std::left << std::setw(10) << "Operation" << std::right
+            << std::setw(10) << "Count" << std::setw(10) << "Mean"
+            << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+            << std::setw(10) << "p99.9" << std::setw(10) << "Max" << "  (ns)\n";
+        for (int i = 0; i < OPERATION_COUNT; ++i) {
+            Operation op = static_cast<Operation>(i);
+            LatencySummary s = summary(op);
+            out << "  " << std::left << std::setw(10) << operationName(op) << std::right
+                << std::setw(10) << s.count << std::setw(10) << static_cast<uint64_t>(s.meanNs())
+                << std::setw(10) << s.percentile(0.50) << std::setw(10) << s.percentile(0.90)
+                << std::setw(10) << s.percentile(0.99) << std::setw(10) << s.percentile(0.999)
+                << std::setw(10) << s.maxNs << "\n";
+        }
+
+        std::vector<SlowOperation> slow = slowest();
+        out << "  Slowest operations:\n";
+        for (size_t i = 0; i < slow.size() && i < top; ++i) {
+            const SlowOperation& s = slow[i];
+            out << "  " << std::setw(4) << i + 1 << ". " << std::left << std::setw(10) << operationName(s.op)
+                << std::right << "ID " << std::setw(9) << s.id << "  steps " << std::setw(6) << s.steps
+                << "  " << std::setw(9) << s.durationNs << " ns  (thread " << s.thread << ")\n";
+        }
+    }
+
+    // Every kept slow operation as a complete event on its thread's track
+    void writeChromeTrace(std::ostream& out) {
+        std::vector<SlowOperation> slow = slowest();
+        size_t threads;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            threads = m_threads.size();
+        }
+
+        out << "{\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]() {
+            out << (first ? "" : ",\n");
+            first = false;
+        };
+        for (size_t t = 0; t < threads; ++t) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+        }
+        out << std::fixed << std::setprecision(3);
+        for (const SlowOperation& s : slow) {
+            separator();
+            out << "{\"name\":\"" << operationName(s.op) << "\",\"cat\":\"student-db\",\"ph\":\"X\",\"pid\":1"
+                << ",\"tid\":" << s.thread << ",\"ts\":" << s.startNs / 1000.0 << ",\"dur\":" << s.durationNs / 1000.0
+                << ",\"args\":{\"id\":" << s.id << ",\"steps\":" << s.steps << "}}";
+        }
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+private:
+    struct ThreadLog {
+        int thread = 0;
+        LatencyHistogram histograms[OPERATION_COUNT];
+        std::atomic<uint64_t> slowThreshold{0}; // fastest kept slow op, once the list is full
+        std::mutex slowLock;                    // the owner takes it only to keep a slow op
+        std::vector<SlowOperation> slowest;     // at most SLOW_CAPACITY, unordered
+    };
+
+    std::mutex m_lock; // guards m_threads
+    std::vector<std::unique_ptr<ThreadLog>> m_threads; // outlive their threads, for later reports
+    std::atomic<long long> m_startNs;
+
+    static SlowOperation* fastestSlow(ThreadLog& log) {
+        return &*std::min_element(log.slowest.begin(), log.slowest.end(),
+                                  [](const SlowOperation& a, const SlowOperation& b) {
+                                      return a.durationNs < b.durationNs;
+                                  });
+    }
+
+    // This thread's log, created on its first operation
+    ThreadLog& local() {
+        thread_local FlightRecorder* owner = nullptr;
+        thread_local ThreadLog* log = nullptr;
+        if (owner != this) {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_threads.push_back(std::make_unique<ThreadLog>());
+            log = m_threads.back().get();
+            log->thread = static_cast<int>(m_threads.size()) - 1;
+            owner = this;
+        }
+        return *log;
+    }
+};
+
+FlightRecorder g_flightRecorder;
+
+// Times one engine operation and hands it to the flight recorder when it
+// goes out of scope. steps is read then, so it covers the whole operation.
+class OperationTimer {
+public:
+    OperationTimer(Operation op, int id, const int& steps)
+        : m_op(op), m_id(id), m_steps(steps), m_start(FlightRecorder::Clock::now()) {}
+
+    ~OperationTimer() {
+        g_flightRecorder.record(m_op, m_id, m_steps, m_start, FlightRecorder::Clock::now());
+    }
+
+    OperationTimer(const OperationTimer&) = delete;
+    OperationTimer& operator=(const OperationTimer&) = delete;
+
+private:
+    Operation m_op;
+    int m_id;
+    const int& m_steps;
+    FlightRecorder::Clock::time_point m_start;
+};
+
 /*
  * ===================================================================
  * 1. BASELINE SOLUTION (Unsorted Vector)
@@ -51,6 +498,17 @@ private:
     std::vector<Student> m_students;
     int m_comparisons = 0; // Counter for analysis
 
+    // Linear Search, counting comparisons
+    Student* locate(int id) {
+        for (Student& s : m_students) {
+            m_comparisons++; // Increment for every check
+            if (s.id == id) {
+                return &s; // Found!
+            }
+        }
+        return nullptr; // Not found
+    }
+
 public:
     int getComparisons() {
         int temp = m_comparisons;
@@ -61,6 +519,8 @@ public:
     // Add a new student.
     // Time Complexity: O(1) (on average)
     void addStudent(const Student& s) {
+        m_comparisons = 0;
+        OperationTimer timer(Operation::Add, s.id, m_comparisons);
         m_students.push_back(s);
     }
 
@@ -68,13 +528,45 @@ public:
     // Time Complexity: O(n)
     Student* findStudent(int id) {
         m_comparisons = 0; // Reset counter
+        OperationTimer timer(Operation::Find, id, m_comparisons);
+        return locate(id);
+    }
+
+    // Update a student's marks. Returns false if the ID is unknown.
+    // Time Complexity: O(n)
+    bool setMarks(int id, double marks) {
+        m_comparisons = 0;
+        OperationTimer timer(Operation::SetMarks, id, m_comparisons);
+        Student* s = locate(id);
+        if (s == nullptr) {
+            return false;
+        }
+        s->marks = marks;
+        return true;
+    }
+
+    // Visit every student, in insertion order.
+    template <typename Visitor>
+    void forEachStudent(Visitor visit) {
         for (Student& s : m_students) {
-            m_comparisons++; // Increment for every check
-            if (s.id == id) {
-                return &s; // Found!
-            }
+            visit(s);
         }
-        return nullptr; // Not found
+    }
+
+    // Bytes held by the database. A vector has no index; its spare
+    // capacity is slack.
+    MemoryReport memoryReport() const {
+        MemoryReport report;
+        report.total = sizeof(*this);
+        if (m_students.capacity() > 0) {
+            size_t block = heapBlockBytes(m_students.data());
+            report.total += block;
+            report.slack += block - MALLOC_CHUNK_HEADER - m_students.size() * sizeof(Student);
+        }
+        for (const Student& s : m_students) {
+            accountStudent(report, s);
+        }
+        return report;
     }
 };
 
@@ -108,6 +600,7 @@ private:
             return;
         }
 
+        m_comparisons++;
         if (s.id < node->data.id) {
             insert(node->left, s);
         } else {
@@ -133,6 +626,17 @@ private:
         }
     }
 
+    // Recursive in-order walk (visits students in ID order)
+    template <typename Visitor>
+    void inOrder(Node* node, Visitor& visit) {
+        if (node == nullptr) {
+            return;
+        }
+        inOrder(node->left.get(), visit);
+        visit(node->data);
+        inOrder(node->right.get(), visit);
+    }
+
 public:
     OptimizedDatabase() : m_root(nullptr) {} // Constructor
 
@@ -144,14 +648,606 @@ public:
 
     // Public addStudent function (calls recursive helper)
     void addStudent(const Student& s) {
+        m_comparisons = 0;
+        OperationTimer timer(Operation::Add, s.id, m_comparisons);
         insert(m_root, s);
     }
 
     // Public findStudent function (calls recursive helper)
     Student* findStudent(int id) {
         m_comparisons = 0; // Reset counter
+        OperationTimer timer(Operation::Find, id, m_comparisons);
         return find(m_root.get(), id);
     }
+
+    // Update a student's marks. Returns false if the ID is unknown.
+    // Time Complexity: O(log n) on average
+    bool setMarks(int id, double marks) {
+        m_comparisons = 0;
+        OperationTimer timer(Operation::SetMarks, id, m_comparisons);
+        Student* s = find(m_root.get(), id);
+        if (s == nullptr) {
+            return false;
+        }
+        s->marks = marks;
+        return true;
+    }
+
+    // Visit every student, in ID order.
+    template <typename Visitor>
+    void forEachStudent(Visitor visit) {
+        inOrder(m_root.get(), visit);
+    }
+
+    // Bytes held by the database. Each node is its own heap block; its
+    // two child links are the index.
+    MemoryReport memoryReport() const {
+        MemoryReport report;
+        report.total = sizeof(*this);
+
+        // Explicit stack: a tree built from sorted IDs is one long chain
+        std::vector<const Node*> pending;
+        if (m_root != nullptr) {
+            pending.push_back(m_root.get());
+        }
+        while (!pending.empty()) {
+            const Node* node = pending.back();
+            pending.pop_back();
+
+            size_t block = heapBlockBytes(node);
+            report.total += block;
+            report.index += sizeof(node->left) + sizeof(node->right);
+            report.slack += block - MALLOC_CHUNK_HEADER - sizeof(Node);
+            accountStudent(report, node->data);
+
+            if (node->left != nullptr) pending.push_back(node->left.get());
+            if (node->right != nullptr) pending.push_back(node->right.get());
+        }
+        return report;
+    }
+};
+
+/*
+ * ===================================================================
+ * 3. SHARDED DATABASE (one engine per shard, one owner thread each)
+ * ===================================================================
+ * Students are partitioned by ID (hash or range) into independent
+ * engines. Only the owner thread ever touches its engine, so the
+ * engines need no locks: other threads send requests through the
+ * shard's queue. Single-ID operations go to one shard; range and
+ * aggregate queries go to every shard that may hold matches and the
+ * partial results are merged.
+ */
+enum class ShardPolicy {
+    HashById,  // spreads any ID pattern evenly
+    RangeById  // keeps neighbouring IDs together, range queries hit fewer shards
+};
+
+// Combined result of an aggregate query
+struct MarksSummary {
+    long count = 0;
+    double totalMarks = 0.0;
+    double minMarks = 0.0;
+    double maxMarks = 0.0;
+
+    double average() const { return count > 0 ? totalMarks / count : 0.0; }
+};
+
+template <typename Engine>
+class ShardedDatabase {
+private:
+    // --- Lock-free multi-producer, single-consumer request queue ---
+    // Producers swap themselves in at m_head; the owner thread is the only
+    // one that follows the links from m_tail.
+    class RequestQueue {
+    private:
+        struct Node {
+            std::function<void(Engine&)> request;
+            std::atomic<Node*> next{nullptr};
+        };
+
+        std::atomic<Node*> m_head;
+        Node* m_tail;
+        Node m_stub;
+
+    public:
+        RequestQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+        ~RequestQueue() {
+            std::function<void(Engine&)> ignored;
+            while (pop(ignored)) {
+            }
+            if (m_tail != &m_stub) {
+                delete m_tail;
+            }
+        }
+
+        // Safe from any number of threads
+        void push(std::function<void(Engine&)> request) {
+            Node* node = new Node();
+            node->request = std::move(request);
+            Node* prev = m_head.exchange(node);
+            prev->next.store(node);
+        }
+
+        // Owner thread only
+        bool pop(std::function<void(Engine&)>& request) {
+            Node* tail = m_tail;
+            Node* next = tail->next.load();
+            if (next == nullptr) {
+                return false;
+            }
+            request = std::move(next->request);
+            m_tail = next; // next becomes the new (already consumed) tail
+            if (tail != &m_stub) {
+                delete tail;
+            }
+            return true;
+        }
+
+        bool empty() const {
+            return m_tail->next.load() == nullptr;
+        }
+    };
+
+    // --- One shard: its engine, its queue and the thread that owns both ---
+    struct Shard {
+        Engine engine;
+        RequestQueue queue;
+        std::thread owner;
+        std::mutex sleepLock;
+        std::condition_variable wake;
+        std::atomic<bool> sleeping{false};
+        bool stop = false;
+    };
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    ShardPolicy m_policy;
+    int m_rangeWidth; // IDs per shard under RangeById
+
+    static void ownerLoop(Shard* shard) {
+        std::function<void(Engine&)> request;
+        while (true) {
+            if (shard->queue.pop(request)) {
+                request(shard->engine);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(shard->sleepLock);
+            shard->sleeping = true;
+            shard->wake.wait(lock, [shard] { return shard->stop || !shard->queue.empty(); });
+            shard->sleeping = false;
+            if (shard->stop && shard->queue.empty()) {
+                return;
+            }
+        }
+    }
+
+    void send(int shard, std::function<void(Engine&)> request) {
+        Shard& s = *m_shards[shard];
+        s.queue.push(std::move(request));
+        if (s.sleeping) {
+            std::lock_guard<std::mutex> lock(s.sleepLock);
+            s.wake.notify_one();
+        }
+    }
+
+    // Run f(engine) on the shard's owner thread and get its result later
+    template <typename F>
+    auto ask(int shard, F f) -> std::future<decltype(f(std::declval<Engine&>()))> {
+        using Result = decltype(f(std::declval<Engine&>()));
+        auto task = std::make_shared<std::packaged_task<Result(Engine&)>>(std::move(f));
+        std::future<Result> result = task->get_future();
+        send(shard, [task](Engine& engine) { (*task)(engine); });
+        return result;
+    }
+
+    // Shards that may hold IDs in [lo, hi]
+    std::vector<int> shardsForRange(int lo, int hi) const {
+        std::vector<int> shards;
+        if (m_policy == ShardPolicy::RangeById) {
+            for (int i = shardFor(lo); i <= shardFor(hi); ++i) {
+                shards.push_back(i);
+            }
+        } else {
+            for (int i = 0; i < shardCount(); ++i) {
+                shards.push_back(i);
+            }
+        }
+        return shards;
+    }
+
+public:
+    // maxId is only used by RangeById, to split [0, maxId] evenly, and
+    // must be given for it.
+    explicit ShardedDatabase(int shards, ShardPolicy policy = ShardPolicy::HashById, int maxId = 0)
+        : m_policy(policy) {
+        if (policy == ShardPolicy::RangeById && maxId <= 0) {
+            throw std::invalid_argument("ShardedDatabase: RangeById needs a positive maxId");
+        }
+        if (shards < 1) {
+            shards = 1;
+        }
+        m_rangeWidth = maxId / shards + 1;
+        for (int i = 0; i < shards; ++i) {
+            m_shards.push_back(std::make_unique<Shard>());
+        }
+        for (auto& shard : m_shards) {
+            shard->owner = std::thread(ownerLoop, shard.get());
+        }
+    }
+
+    ~ShardedDatabase() {
+        for (auto& shard : m_shards) {
+            {
+                std::lock_guard<std::mutex> lock(shard->sleepLock);
+                shard->stop = true;
+            }
+            shard->wake.notify_one();
+        }
+        for (auto& shard : m_shards) {
+            shard->owner.join();
+        }
+    }
+
+    int shardCount() const {
+        return static_cast<int>(m_shards.size());
+    }
+
+    int shardFor(int id) const {
+        if (m_policy == ShardPolicy::RangeById) {
+            int shard = id / m_rangeWidth;
+            return std::max(0, std::min(shard, shardCount() - 1));
+        }
+        // Fibonacci hashing: consecutive IDs land on different shards
+        unsigned int mixed = static_cast<unsigned int>(id) * 2654435769u;
+        return static_cast<int>((static_cast<unsigned long long>(mixed) * m_shards.size()) >> 32);
+    }
+
+    // Queue an insert and return immediately; inserts to one shard stay in order.
+    void addStudent(const Student& s) {
+        send(shardFor(s.id), [s](Engine& engine) { engine.addStudent(s); });
+    }
+
+    // Returns a copy: the record itself belongs to the shard's thread.
+    std::optional<Student> findStudent(int id) {
+        return ask(shardFor(id), [id](Engine& engine) -> std::optional<Student> {
+            const Student* s = engine.findStudent(id);
+            if (s == nullptr) {
+                return std::nullopt;
+            }
+            return *s;
+        }).get();
+    }
+
+    // Queue a marks update; the future says whether the ID existed.
+    std::future<bool> setMarks(int id, double marks) {
+        return ask(shardFor(id), [id, marks](Engine& engine) { return engine.setMarks(id, marks); });
+    }
+
+    // Wait until every request queued so far has been applied.
+    void flush() {
+        std::vector<std::future<void>> done;
+        for (int i = 0; i < shardCount(); ++i) {
+            done.push_back(ask(i, [](Engine&) {}));
+        }
+        for (auto& d : done) {
+            d.get();
+        }
+    }
+
+    // All students with lo <= id <= hi, in ID order.
+    std::vector<Student> findRange(int lo, int hi) {
+        std::vector<std::future<std::vector<Student>>> parts;
+        for (int shard : shardsForRange(lo, hi)) {
+            parts.push_back(ask(shard, [lo, hi](Engine& engine) {
+                std::vector<Student> found;
+                engine.forEachStudent([&](const Student& s) {
+                    if (s.id >= lo && s.id <= hi) {
+                        found.push_back(s);
+                    }
+                });
+                // Sort on the shard's thread so the caller only merges
+                std::sort(found.begin(), found.end(),
+                          [](const Student& a, const Student& b) { return a.id < b.id; });
+                return found;
+            }));
+        }
+
+        std::vector<Student> merged;
+        for (auto& part : parts) {
+            std::vector<Student> piece = part.get();
+            size_t middle = merged.size();
+            merged.insert(merged.end(), piece.begin(), piece.end());
+            std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end(),
+                               [](const Student& a, const Student& b) { return a.id < b.id; });
+        }
+        return merged;
+    }
+
+    // Memory of every shard's engine combined, plus the shards themselves.
+    MemoryReport memoryReport() {
+        std::vector<std::future<MemoryReport>> parts;
+        for (int i = 0; i < shardCount(); ++i) {
+            parts.push_back(ask(i, [](Engine& engine) { return engine.memoryReport(); }));
+        }
+
+        MemoryReport total;
+        total.total = sizeof(*this) + m_shards.capacity() * sizeof(m_shards[0]);
+        for (int i = 0; i < shardCount(); ++i) {
+            MemoryReport part = parts[i].get();
+            // The engine lives inside the Shard block; count that block instead
+            part.total -= sizeof(Engine);
+            total.add(part);
+            total.total += heapBlockBytes(m_shards[i].get());
+        }
+        return total;
+    }
+
+    // Count, average, min and max marks over every student.
+    MarksSummary summarizeMarks() {
+        std::vector<std::future<MarksSummary>> parts;
+        for (int i = 0; i < shardCount(); ++i) {
+            parts.push_back(ask(i, [](Engine& engine) {
+                MarksSummary part;
+                engine.forEachStudent([&](const Student& s) {
+                    if (part.count == 0 || s.marks < part.minMarks) part.minMarks = s.marks;
+                    if (part.count == 0 || s.marks > part.maxMarks) part.maxMarks = s.marks;
+                    part.totalMarks += s.marks;
+                    part.count++;
+                });
+                return part;
+            }));
+        }
+
+        MarksSummary total;
+        for (auto& part : parts) {
+            MarksSummary p = part.get();
+            if (p.count == 0) {
+                continue;
+            }
+            if (total.count == 0 || p.minMarks < total.minMarks) total.minMarks = p.minMarks;
+            if (total.count == 0 || p.maxMarks > total.maxMarks) total.maxMarks = p.maxMarks;
+            total.totalMarks += p.totalMarks;
+            total.count += p.count;
+        }
+        return total;
+    }
+};
+
+/*
+ * ===================================================================
+ * 4. ADAPTIVE DATABASE (append log + sorted array, merged in background)
+ * ===================================================================
+ * Writes go to an unsorted append log, as in the baseline: O(1).
+ * Reads binary-search a sorted array and then scan the log. The
+ * engine counts reads and writes per window of operations; when the
+ * log scans of the last window cost more than merging the log into
+ * the sorted array once, the log is frozen and merged on a background
+ * thread. Queries keep running against the frozen log and the old
+ * array until the merged array is ready, then switch over.
+ *
+ * The sorted array and a frozen log are never modified, so the merge
+ * thread can read them without locks. A marks update is written as a
+ * new copy of the record into the log; the newest copy wins.
+ */
+class AdaptiveDatabase {
+private:
+    using SortedRun = std::vector<Student>;
+
+    std::shared_ptr<const SortedRun> m_sorted;  // sorted by ID, one record per ID
+    std::shared_ptr<const SortedRun> m_frozen;  // log being merged (null if none)
+    std::vector<Student> m_log;                 // newest writes, unsorted
+    std::future<std::shared_ptr<const SortedRun>> m_merge;
+
+    int m_comparisons = 0; // Counter for analysis
+
+    // Workload of the current window
+    static const int WINDOW = 256;
+    int m_windowOps = 0;
+    long long m_windowReads = 0;
+    long long m_windowWrites = 0;
+    bool m_lastWindowReadHeavy = false; // for display only; merges are decided by cost
+    int m_merges = 0;
+
+    // Sorted array of base with every record of log applied (later wins)
+    static std::shared_ptr<const SortedRun> mergeRuns(std::shared_ptr<const SortedRun> base,
+                                                      std::shared_ptr<const SortedRun> log) {
+        std::vector<const Student*> updates;
+        updates.reserve(log->size());
+        for (const Student& s : *log) {
+            updates.push_back(&s);
+        }
+        std::stable_sort(updates.begin(), updates.end(),
+                         [](const Student* a, const Student* b) { return a->id < b->id; });
+
+        auto merged = std::make_shared<SortedRun>();
+        merged->reserve(base->size() + updates.size());
+        size_t i = 0;
+        size_t j = 0;
+        while (i < base->size() || j < updates.size()) {
+            if (j == updates.size() || (i < base->size() && (*base)[i].id < updates[j]->id)) {
+                merged->push_back((*base)[i++]);
+                continue;
+            }
+            // Newest copy of this ID: the last one in the (stable) sorted log
+            int id = updates[j]->id;
+            while (j + 1 < updates.size() && updates[j + 1]->id == id) {
+                j++;
+            }
+            merged->push_back(*updates[j++]);
+            if (i < base->size() && (*base)[i].id == id) {
+                i++; // replaced
+            }
+        }
+        return merged;
+    }
+
+    // Install a finished merge; never waits for one that is still running.
+    void collectMerge() {
+        if (m_merge.valid() && m_merge.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            m_sorted = m_merge.get();
+            m_frozen.reset();
+            m_merges++;
+        }
+    }
+
+    void recordOperation(bool write) {
+        collectMerge();
+        (write ? m_windowWrites : m_windowReads)++;
+        if (++m_windowOps < WINDOW) {
+            return;
+        }
+
+        // Reads of this window scanned the whole log; a merge costs one pass
+        // over everything. Merge when scanning has become the larger cost.
+        m_lastWindowReadHeavy = m_windowReads > m_windowWrites;
+        bool worthMerging = static_cast<size_t>(m_windowReads) * m_log.size() > m_sorted->size() + m_log.size();
+        if (!m_log.empty() && !m_merge.valid() && worthMerging) {
+            m_frozen = std::make_shared<const SortedRun>(std::move(m_log));
+            m_log.clear();
+            m_merge = std::async(std::launch::async, mergeRuns, m_sorted, m_frozen);
+        }
+        m_windowOps = 0;
+        m_windowReads = 0;
+        m_windowWrites = 0;
+    }
+
+    // Newest copy of the ID: active log, then frozen log, then sorted array
+    const Student* lookup(int id) {
+        for (auto it = m_log.rbegin(); it != m_log.rend(); ++it) {
+            m_comparisons++;
+            if (it->id == id) {
+                return &*it;
+            }
+        }
+        if (m_frozen) {
+            for (auto it = m_frozen->rbegin(); it != m_frozen->rend(); ++it) {
+                m_comparisons++;
+                if (it->id == id) {
+                    return &*it;
+                }
+            }
+        }
+        int left = 0;
+        int right = static_cast<int>(m_sorted->size()) - 1;
+        while (left <= right) {
+            m_comparisons++;
+            int mid = left + (right - left) / 2;
+            const Student& s = (*m_sorted)[mid];
+            if (s.id == id) {
+                return &s;
+            } else if (id < s.id) {
+                right = mid - 1;
+            } else {
+                left = mid + 1;
+            }
+        }
+        return nullptr;
+    }
+
+public:
+    AdaptiveDatabase() : m_sorted(std::make_shared<const SortedRun>()) {}
+
+    ~AdaptiveDatabase() {
+        if (m_merge.valid()) {
+            m_merge.wait();
+        }
+    }
+
+    int getComparisons() {
+        int temp = m_comparisons;
+        m_comparisons = 0; // Reset after reading
+        return temp;
+    }
+
+    // Add a new student to the log.
+    // Time Complexity: O(1) (on average)
+    void addStudent(const Student& s) {
+        m_comparisons = 0;
+        OperationTimer timer(Operation::Add, s.id, m_comparisons);
+        recordOperation(true);
+        m_log.push_back(s);
+    }
+
+    // Find the newest copy of a student. The pointer stays valid until
+    // the next call into the database.
+    // Time Complexity: O(log n + log size)
+    const Student* findStudent(int id) {
+        m_comparisons = 0; // Reset counter
+        OperationTimer timer(Operation::Find, id, m_comparisons);
+        recordOperation(false);
+        return lookup(id);
+    }
+
+    // Update a student's marks by logging a new copy of the record.
+    bool setMarks(int id, double marks) {
+        m_comparisons = 0;
+        OperationTimer timer(Operation::SetMarks, id, m_comparisons);
+        recordOperation(true);
+        const Student* s = lookup(id);
+        if (s == nullptr) {
+            return false;
+        }
+        Student updated = *s;
+        updated.marks = marks;
+        m_log.push_back(updated);
+        return true;
+    }
+
+    // Block until a running merge has been installed (for tests and demos).
+    void waitForMerge() {
+        if (m_merge.valid()) {
+            m_merge.wait();
+            collectMerge();
+        }
+    }
+
+    size_t logSize() const { return m_log.size() + (m_frozen ? m_frozen->size() : 0); }
+    size_t sortedSize() const { return m_sorted->size(); }
+    int merges() const { return m_merges; }
+    bool mergeRunning() const { return m_merge.valid(); }
+
+    // Whether reads or writes dominated the last full window. Only a
+    // statistic: merges start when log scans cost more than a merge, and
+    // the log and sorted sizes show which structure is serving reads.
+    const char* lastWindowMix() const {
+        return m_lastWindowReadHeavy ? "read-heavy" : "write-heavy";
+    }
+
+    // Visit the newest copy of every student, in ID order.
+    template <typename Visitor>
+    void forEachStudent(Visitor visit) {
+        auto log = std::make_shared<SortedRun>(m_frozen ? *m_frozen : SortedRun());
+        log->insert(log->end(), m_log.begin(), m_log.end());
+        std::shared_ptr<const SortedRun> all = mergeRuns(m_sorted, log);
+        for (const Student& s : *all) {
+            visit(s);
+        }
+    }
+
+    // Bytes held by the database. The log is unsorted and has no index;
+    // records it holds that replace older copies are counted as slack.
+    MemoryReport memoryReport() const {
+        MemoryReport report;
+        report.total = sizeof(*this);
+        auto addRun = [&report](const std::vector<Student>& run) {
+            if (run.capacity() > 0) {
+                size_t block = heapBlockBytes(run.data());
+                report.total += block;
+                report.slack += block - MALLOC_CHUNK_HEADER - run.size() * sizeof(Student);
+            }
+            for (const Student& s : run) {
+                accountStudent(report, s);
+            }
+        };
+        addRun(*m_sorted);
+        if (m_frozen) {
+            addRun(*m_frozen);
+        }
+        addRun(m_log);
+        return report;
+    }
 };
 
 /*
@@ -160,7 +1256,15 @@ public:
  * A function to simulate and demonstrate both databases.
  * -------------------------------------------------------------------
  */
-int main() {
+int main(int argc, char* argv[]) {
+    std::string tracePath; // --trace=<file>: write the slowest operations as a Chrome trace
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--trace=", 0) == 0) {
+            tracePath = arg.substr(8);
+        }
+    }
+
     std::cout << "===== Student ID Search Simulation =====" << std::endl;
 
     // --- Define our student data ---
@@ -215,6 +1319,180 @@ int main() {
     std::cout << "  Comparisons made: " << db_optimized.getComparisons() << std::endl;
     std::cout << "  *** Analysis: This is O(log n). It only checked 3 items. ***" << std::endl;
 
+    // 3. Demonstrate Sharded (4 BST shards, each owned by its own thread)
+    std::cout << "\n--- 3. Sharded (4 x Binary Search Tree) Test ---" << std::endl;
+    ShardedDatabase<OptimizedDatabase> db_sharded(4);
+    for (const auto& s : students) {
+        db_sharded.addStudent(s);
+    }
+    db_sharded.setMarks(idToFind, 90.0).get();
+
+    std::cout << "Searching for ID: " << idToFind << " (shard "
+              << db_sharded.shardFor(idToFind) << ")" << std::endl;
+    std::optional<Student> s_sharded = db_sharded.findStudent(idToFind);
+    if (s_sharded) {
+        std::cout << "Found student (Sharded):" << std::endl;
+        s_sharded->print();
+    } else {
+        std::cout << "Student not found." << std::endl;
+    }
+
+    std::cout << "  Students with ID 50-150 (merged from all shards):";
+    for (const Student& s : db_sharded.findRange(50, 150)) {
+        std::cout << " " << s.id;
+    }
+    std::cout << std::endl;
+
+    MarksSummary summary = db_sharded.summarizeMarks();
+    std::cout << "  Students: " << summary.count << ", average marks: " << summary.average()
+              << ", min: " << summary.minMarks << ", max: " << summary.maxMarks << std::endl;
+    std::cout << "  *** Analysis: Writes to different shards never contend. ***" << std::endl;
+
+    // 4. Demonstrate Adaptive: a registration week, then results season
+    std::cout << "\n--- 4. Adaptive (Append Log + Sorted Array) Test ---" << std::endl;
+    {
+        AdaptiveDatabase db_adaptive;
+        const int cohortSize = 50000;
+        std::mt19937 phaseRng(7);
+        std::vector<int> ids;
+
+        // Registration: almost only writes, so the log just grows
+        long long comparisons = 0;
+        int finds = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < cohortSize; ++i) {
+            int id = static_cast<int>(phaseRng() % 100000000);
+            ids.push_back(id);
+            db_adaptive.addStudent(Student(id, "Student " + std::to_string(id), 0.0));
+            if (i % 100 == 0) {
+                db_adaptive.findStudent(ids[phaseRng() % ids.size()]);
+                comparisons += db_adaptive.getComparisons();
+                finds++;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  Registration: " << cohortSize << " adds, " << finds << " finds in "
+                  << seconds * 1000.0 << " ms, " << comparisons / finds << " comparisons per find" << std::endl;
+        std::cout << "  Last window: " << db_adaptive.lastWindowMix() << ", log " << db_adaptive.logSize()
+                  << ", sorted " << db_adaptive.sortedSize() << ", merges " << db_adaptive.merges() << std::endl;
+
+        // Results season: reads dominate, the log is merged in the background
+        comparisons = 0;
+        finds = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 4 * cohortSize; ++i) {
+            int id = ids[phaseRng() % ids.size()];
+            if (i % 50 == 0) {
+                db_adaptive.setMarks(id, 40.0 + phaseRng() % 60);
+            } else {
+                db_adaptive.findStudent(id);
+                comparisons += db_adaptive.getComparisons();
+                finds++;
+            }
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  Results season: " << finds << " finds, " << 4 * cohortSize - finds << " mark updates in "
+                  << seconds * 1000.0 << " ms, " << comparisons / finds << " comparisons per find" << std::endl;
+        std::cout << "  Last window: " << db_adaptive.lastWindowMix() << ", log " << db_adaptive.logSize()
+                  << ", sorted " << db_adaptive.sortedSize() << ", merges " << db_adaptive.merges() << std::endl;
+    }
+    std::cout << "  *** Analysis: O(1) adds while registering, O(log n) finds once reads dominate. ***" << std::endl;
+
+    // 5. Memory footprint of each engine with a realistic number of students
+    const int memoryStudents = 100000;
+    std::cout << "\n--- 5. Memory Footprint (" << memoryStudents << " students) ---" << std::endl;
+
+    std::vector<Student> cohort;
+    std::mt19937 rng(2024);
+    for (int i = 0; i < memoryStudents; ++i) {
+        int id = static_cast<int>(rng() % 100000000);
+        cohort.push_back(Student(id, "Student " + std::to_string(id), 50.0 + rng() % 50));
+    }
+
+    {
+        long long before = g_heapBytes.load();
+        BaselineDatabase memory_baseline;
+        for (const auto& s : cohort) {
+            memory_baseline.addStudent(s);
+        }
+        std::cout << "Baseline (Unsorted Vector):" << std::endl;
+        memory_baseline.memoryReport().print();
+        std::cout << "  Heap measured by allocator: " << g_heapBytes.load() - before << " bytes" << std::endl;
+    }
+
+    {
+        long long before = g_heapBytes.load();
+        OptimizedDatabase memory_optimized;
+        for (const auto& s : cohort) {
+            memory_optimized.addStudent(s);
+        }
+        std::cout << "Optimized (Binary Search Tree):" << std::endl;
+        memory_optimized.memoryReport().print();
+        std::cout << "  Heap measured by allocator: " << g_heapBytes.load() - before << " bytes" << std::endl;
+    }
+
+    {
+        long long before = g_heapBytes.load();
+        AdaptiveDatabase memory_adaptive;
+        for (const auto& s : cohort) {
+            memory_adaptive.addStudent(s);
+        }
+        std::cout << "Adaptive (all " << memory_adaptive.logSize() << " students still in the log):" << std::endl;
+        memory_adaptive.memoryReport().print();
+        std::cout << "  Heap measured by allocator: " << g_heapBytes.load() - before << " bytes" << std::endl;
+    }
+
+    {
+        ShardedDatabase<OptimizedDatabase> memory_sharded(4);
+        for (const auto& s : cohort) {
+            memory_sharded.addStudent(s);
+        }
+        memory_sharded.flush();
+        std::cout << "Sharded (4 x Binary Search Tree):" << std::endl;
+        memory_sharded.memoryReport().print();
+    }
+    std::cout << "  *** Analysis: Tree nodes pay for two links and a heap block per student. ***" << std::endl;
+
+    // 6. Latency of every operation, recorded all along; this run resets it
+    // first so only the sharded workload below is reported.
+    std::cout << "\n--- 6. Latency Flight Recorder (4 x Binary Search Tree) ---" << std::endl;
+    g_flightRecorder.reset();
+    {
+        ShardedDatabase<OptimizedDatabase> latency_sharded(4);
+        std::mt19937 latencyRng(99);
+        std::vector<int> ids;
+        for (int i = 0; i < 50000; ++i) {
+            int id = static_cast<int>(latencyRng() % 100000000);
+            ids.push_back(id);
+            latency_sharded.addStudent(Student(id, "Student " + std::to_string(id), 0.0));
+        }
+        // A late batch registered in ID order: each shard's tree grows a long chain
+        for (int id = 100000000; id < 100004000; ++id) {
+            ids.push_back(id);
+            latency_sharded.addStudent(Student(id, "Late " + std::to_string(id), 0.0));
+        }
+
+        std::vector<std::future<bool>> updates;
+        for (int i = 0; i < 100000; ++i) {
+            int id = ids[latencyRng() % ids.size()];
+            if (i % 10 == 0) {
+                updates.push_back(latency_sharded.setMarks(id, 40.0 + latencyRng() % 60));
+            } else {
+                latency_sharded.findStudent(id);
+            }
+        }
+        for (auto& u : updates) {
+            u.get();
+        }
+    }
+    g_flightRecorder.printReport(std::cout);
+    if (!tracePath.empty()) {
+        std::ofstream trace(tracePath);
+        g_flightRecorder.writeChromeTrace(trace);
+        std::cout << "  Chrome trace written to " << tracePath << std::endl;
+    }
+    std::cout << "  *** Analysis: Steps tell a deep chain (late batch) from a stall outside the tree. ***" << std::endl;
+
     std::cout << "\n===== Simulation Complete =====" << std::endl;
     return 0;
 }
@@ -3,187 +3,2850 @@
 #include <algorithm>
 #include <limits>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <cerrno>
+#include <sstream>
+#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <shared_mutex>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sched.h>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
 
 using namespace std;
 
+// --------- Heap tracking ---------
+// Every operator new/delete is counted at the size the allocator really
+// hands out, so the memory report can be checked against the heap itself.
+const size_t MALLOC_CHUNK_HEADER = sizeof(size_t); // glibc keeps the block size in front
+
+atomic<long long> g_heapBytes(0);
+atomic<long long> g_heapBlocks(0);
+
+// Bytes a malloc'd block really occupies (usable size plus the header)
+size_t heapBlockBytes(const void *p) {
+    return malloc_usable_size(const_cast<void *>(p)) + MALLOC_CHUNK_HEADER;
+}
+
+void *operator new(size_t size) {
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw bad_alloc();
+    g_heapBytes.fetch_add(static_cast<long long>(heapBlockBytes(p)), memory_order_relaxed);
+    g_heapBlocks.fetch_add(1, memory_order_relaxed);
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    if (p == nullptr) return;
+    g_heapBytes.fetch_sub(static_cast<long long>(heapBlockBytes(p)), memory_order_relaxed);
+    g_heapBlocks.fetch_sub(1, memory_order_relaxed);
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    operator delete(p);
+}
+
+// --------- Inline string: short text stored inside the record ---------
+// Up to N - 1 characters live in the object itself; only longer text goes
+// to the heap. Names, courses and subject names are almost always short, so
+// building a student normally allocates nothing for them.
+template <size_t N>
+class InlineString {
+private:
+    uint32_t m_size = 0;
+    char *m_heap = nullptr;   // only for text that does not fit inline
+    char m_inline[N] = {};
+
+    void assign(const char *text, size_t length) {
+        char *target = m_inline;
+        if (length >= N) {
+            target = new char[length + 1];
+        }
+        memcpy(target, text, length);
+        target[length] = '\0';
+        delete[] m_heap;
+        m_heap = (target == m_inline) ? nullptr : target;
+        m_size = static_cast<uint32_t>(length);
+    }
+
+public:
+    InlineString() = default;
+    InlineString(const char *text) { assign(text, strlen(text)); }
+    InlineString(const string &text) { assign(text.data(), text.size()); }
+
+    InlineString(const InlineString &other) { assign(other.data(), other.size()); }
+
+    InlineString(InlineString &&other) noexcept : m_size(other.m_size), m_heap(other.m_heap) {
+        memcpy(m_inline, other.m_inline, N);
+        other.m_heap = nullptr;
+        other.m_size = 0;
+        other.m_inline[0] = '\0';
+    }
+
+    InlineString &operator=(const InlineString &other) {
+        if (this != &other) assign(other.data(), other.size());
+        return *this;
+    }
+
+    InlineString &operator=(InlineString &&other) noexcept {
+        if (this != &other) {
+            delete[] m_heap;
+            m_size = other.m_size;
+            m_heap = other.m_heap;
+            memcpy(m_inline, other.m_inline, N);
+            other.m_heap = nullptr;
+            other.m_size = 0;
+            other.m_inline[0] = '\0';
+        }
+        return *this;
+    }
+
+    InlineString &operator=(const string &text) {
+        assign(text.data(), text.size());
+        return *this;
+    }
+
+    InlineString &operator=(const char *text) {
+        assign(text, strlen(text));
+        return *this;
+    }
+
+    ~InlineString() {
+        delete[] m_heap;
+    }
+
+    const char *data() const { return m_heap != nullptr ? m_heap : m_inline; }
+    const char *c_str() const { return data(); }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool onHeap() const { return m_heap != nullptr; }
+    string str() const { return string(data(), m_size); }
+    operator string_view() const { return string_view(data(), m_size); }
+
+    bool operator==(const char *text) const { return string_view(*this) == text; }
+};
+
+template <size_t N>
+ostream &operator<<(ostream &out, const InlineString<N> &text) {
+    return out.write(text.data(), static_cast<streamsize>(text.size()));
+}
+
+// --------- Small vector: the first N elements stored inside the object ---------
+template <typename T, size_t N>
+class SmallVector {
+public:
+    static const size_t INLINE_CAPACITY = N;
+
+private:
+    T *m_data;
+    size_t m_size = 0;
+    size_t m_capacity = N;
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+    T *inlineData() { return reinterpret_cast<T *>(m_inline); }
+    bool isInline() const { return m_data == reinterpret_cast<const T *>(m_inline); }
+
+    void grow() {
+        size_t capacity = m_capacity * 2;
+        T *bigger = static_cast<T *>(::operator new(capacity * sizeof(T)));
+        for (size_t i = 0; i < m_size; ++i) {
+            new (bigger + i) T(move(m_data[i]));
+            m_data[i].~T();
+        }
+        if (!isInline()) ::operator delete(m_data);
+        m_data = bigger;
+        m_capacity = capacity;
+    }
+
+    // Take other's elements; other is left empty.
+    void steal(SmallVector &other) {
+        if (other.isInline()) {
+            m_data = inlineData();
+            m_capacity = N;
+            for (size_t i = 0; i < other.m_size; ++i) {
+                new (m_data + i) T(move(other.m_data[i]));
+                other.m_data[i].~T();
+            }
+        } else {
+            m_data = other.m_data;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inlineData();
+            other.m_capacity = N;
+        }
+        m_size = other.m_size;
+        other.m_size = 0;
+    }
+
+public:
+    SmallVector() : m_data(inlineData()) {}
+
+    SmallVector(const SmallVector &other) : m_data(inlineData()) {
+        for (const T &item : other) push_back(item);
+    }
+
+    SmallVector(SmallVector &&other) noexcept : m_data(inlineData()) {
+        steal(other);
+    }
+
+    SmallVector &operator=(const SmallVector &other) {
+        if (this != &other) {
+            clear();
+            for (const T &item : other) push_back(item);
+        }
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other) noexcept {
+        if (this != &other) {
+            clear();
+            if (!isInline()) ::operator delete(m_data);
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        clear();
+        if (!isInline()) ::operator delete(m_data);
+    }
+
+    void push_back(const T &item) {
+        if (m_size == m_capacity) grow();
+        new (m_data + m_size) T(item);
+        m_size++;
+    }
+
+    void push_back(T &&item) {
+        if (m_size == m_capacity) grow();
+        new (m_data + m_size) T(move(item));
+        m_size++;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < m_size; ++i) m_data[i].~T();
+        m_size = 0;
+    }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    bool onHeap() const { return !isInline(); }
+    T &operator[](size_t i) { return m_data[i]; }
+    const T &operator[](size_t i) const { return m_data[i]; }
+    T *begin() { return m_data; }
+    T *end() { return m_data + m_size; }
+    const T *begin() const { return m_data; }
+    const T *end() const { return m_data + m_size; }
+};
+
 // --------- Subject and Student structures ---------
+// A float keeps about seven significant digits, plenty for a mark out of
+// 100, and keeps the record at 48 bytes instead of 56.
 struct SubjectRecord {
-    string name;
-    double mark;
+    InlineString<24> name;
+    float mark;
     bool hasMark;
 };
 
+// Subjects of one student; up to 4 are kept inline. Most students take
+// three or four, and every inline slot is paid for by every student.
+using SubjectList = SmallVector<SubjectRecord, 4>;
+
+// --------- Versioned marks (MVCC) ---------
+// A mark update never edits a transcript in place. It publishes a new
+// immutable version stamped with a commit timestamp, so a reader always sees
+// either the whole old transcript or the whole new one, and never takes a lock.
+struct MarkVersion {
+    uint64_t commitTs;              // 0 = as registered, before any marks
+    SubjectList subjects;
+    MarkVersion *older;             // previous version, kept for older snapshots
+};
+
+atomic<uint64_t> g_commitClock(0);  // timestamp of the latest committed update
+mutex g_commitMutex;                // serializes writers only, readers never take it
+
+// Each reading thread announces the snapshot it is reading in a slot. The
+// oldest announced snapshot is the epoch below which versions can be freed.
+const int MAX_READER_SLOTS = 64;
+const uint64_t NO_SNAPSHOT = numeric_limits<uint64_t>::max();
+
+struct alignas(64) ReaderSlot {
+    atomic<uint64_t> snapshotTs{NO_SNAPSHOT};
+    atomic<bool> taken{false};
+};
+
+ReaderSlot g_readerSlots[MAX_READER_SLOTS];
+
+struct ReaderThreadState {
+    int slot = -1;       // slot held by the open snapshot, -1 = none
+    int lastSlot = 0;    // tried first next time; usually still free
+    int depth = 0;       // nested snapshots on one thread share the outer one
+    uint64_t ts = 0;
+};
+
+thread_local ReaderThreadState t_reader;
+
+// Take a free reader slot. A slot is held only while a snapshot is open,
+// so more than MAX_READER_SLOTS threads can read; the extra ones wait for
+// a snapshot to close.
+int acquireReaderSlot() {
+    const int WARN_AFTER = 100000; // yields before reporting the wait
+    for (int attempt = 0;; ++attempt) {
+        for (int k = 0; k < MAX_READER_SLOTS; ++k) {
+            int i = (t_reader.lastSlot + k) % MAX_READER_SLOTS;
+            bool expected = false;
+            if (g_readerSlots[i].taken.compare_exchange_strong(expected, true)) {
+                t_reader.lastSlot = i;
+                return i;
+            }
+        }
+        if (attempt == WARN_AFTER) {
+            cerr << "Warning: all " << MAX_READER_SLOTS << " reader slots are held by open snapshots; waiting.\n";
+        }
+        this_thread::yield(); // all slots busy
+    }
+}
+
+// --------- Snapshot guard: everything read inside sees one point in time ---------
+class ReadSnapshot {
+public:
+    ReadSnapshot() {
+        if (t_reader.depth++ > 0) return;
+        t_reader.slot = acquireReaderSlot();
+
+        // Re-check the clock after announcing, so a writer that commits in
+        // between either sees our slot or we pick up its newer timestamp.
+        atomic<uint64_t> &announced = g_readerSlots[t_reader.slot].snapshotTs;
+        uint64_t ts;
+        do {
+            ts = g_commitClock.load();
+            announced.store(ts);
+        } while (ts != g_commitClock.load());
+        t_reader.ts = ts;
+    }
+
+    ~ReadSnapshot() {
+        if (--t_reader.depth == 0) {
+            ReaderSlot &slot = g_readerSlots[t_reader.slot];
+            slot.snapshotTs.store(NO_SNAPSHOT);
+            slot.taken.store(false);
+            t_reader.slot = -1;
+        }
+    }
+
+    ReadSnapshot(const ReadSnapshot &) = delete;
+    ReadSnapshot &operator=(const ReadSnapshot &) = delete;
+
+    uint64_t timestamp() const { return t_reader.ts; }
+};
+
+// Oldest snapshot any reader is still using (NO_SNAPSHOT if none)
+uint64_t oldestActiveSnapshot() {
+    uint64_t oldest = NO_SNAPSHOT;
+    for (int i = 0; i < MAX_READER_SLOTS; ++i) {
+        uint64_t ts = g_readerSlots[i].snapshotTs.load();
+        if (ts < oldest) oldest = ts;
+    }
+    return oldest;
+}
+
+// --------- Version chain of one student's marks (newest first) ---------
+class VersionChain {
+private:
+    atomic<MarkVersion *> m_head{nullptr};
+
+    static void freeChain(MarkVersion *v) {
+        while (v != nullptr) {
+            MarkVersion *older = v->older;
+            delete v;
+            v = older;
+        }
+    }
+
+    // Drop versions no active snapshot can reach. Caller holds g_commitMutex.
+    void pruneLocked() {
+        uint64_t oldest = oldestActiveSnapshot();
+        MarkVersion *v = m_head.load();
+        while (v != nullptr && v->commitTs > oldest) {
+            v = v->older;
+        }
+        // Every reader stops at v or before it, so nothing past v is reachable.
+        if (v != nullptr) {
+            MarkVersion *garbage = v->older;
+            v->older = nullptr;
+            freeChain(garbage);
+        }
+    }
+
+public:
+    VersionChain() = default;
+
+    explicit VersionChain(SubjectList subjects) {
+        m_head.store(new MarkVersion{0, move(subjects), nullptr});
+    }
+
+    VersionChain(const VersionChain &) = delete;
+    VersionChain &operator=(const VersionChain &) = delete;
+
+    VersionChain(VersionChain &&other) noexcept {
+        m_head.store(other.m_head.exchange(nullptr));
+    }
+
+    VersionChain &operator=(VersionChain &&other) noexcept {
+        MarkVersion *mine = m_head.load();
+        m_head.store(other.m_head.exchange(nullptr));
+        freeChain(mine);
+        return *this;
+    }
+
+    ~VersionChain() {
+        freeChain(m_head.load());
+    }
+
+    // Subjects as of the snapshot; valid while the snapshot is alive.
+    const SubjectList &read(const ReadSnapshot &snap) const {
+        static const SubjectList none;
+        MarkVersion *v = m_head.load(memory_order_acquire);
+        while (v != nullptr && v->commitTs > snap.timestamp()) {
+            v = v->older;
+        }
+        return v != nullptr ? v->subjects : none;
+    }
+
+    // Visit every version still kept, newest first. Takes the commit lock so
+    // no version is freed while it is being visited.
+    template <typename Visitor>
+    void forEachVersion(Visitor visit) const {
+        lock_guard<mutex> lock(g_commitMutex);
+        for (MarkVersion *v = m_head.load(); v != nullptr; v = v->older) {
+            visit(*v);
+        }
+    }
+
+    // Publish a complete new transcript and return its commit timestamp.
+    uint64_t publish(SubjectList subjects) {
+        lock_guard<mutex> lock(g_commitMutex);
+        uint64_t ts = g_commitClock.load() + 1;
+        m_head.store(new MarkVersion{ts, move(subjects), m_head.load()}, memory_order_release);
+        g_commitClock.store(ts);
+        pruneLocked();
+        return ts;
+    }
+};
+
+// Move-only: a student is built once and moved into the array, never copied.
 struct Student {
     int id;
-    string name;
-    string course;
-    vector<SubjectRecord> subjects;
+    InlineString<40> name;
+    InlineString<32> course;
+    VersionChain transcript; // subjects and marks, one version per update
 };
 
-// --------- Helper: safely read an integer ---------
-int readInt(const string &prompt) {
-    int value;
+// Split "a|b|c" style fields; keeps empty fields.
+vector<string> splitFields(const string &text, char sep) {
+    vector<string> fields;
+    size_t start = 0;
     while (true) {
-        cout << prompt;
-        if (cin >> value) {
-            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
-            return value;
-        } else {
-            cout << "Wrong input, please enter another input (integer).\n";
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        size_t end = text.find(sep, start);
+        if (end == string::npos) {
+            fields.push_back(text.substr(start));
+            return fields;
         }
+        fields.push_back(text.substr(start, end - start));
+        start = end + 1;
     }
 }
 
-// --------- Helper: safely read a double ---------
-double readDouble(const string &prompt) {
-    double value;
-    while (true) {
-        cout << prompt;
-        if (cin >> value) {
-            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
-            return value;
-        } else {
-            cout << "Wrong input, please enter another input (number).\n";
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+// --------- Big-array memory: huge pages and NUMA placement ---------
+// The student array and the ID column grow to many GB, where random probes
+// miss the TLB on every step. Arrays of 2 MB or more are therefore mapped
+// directly: first with explicit huge pages (MAP_HUGETLB, needs pages
+// reserved by the admin), otherwise as normal memory marked for transparent
+// huge pages. On machines with several NUMA nodes the mapping can also be
+// interleaved across nodes or bound to one. Smaller arrays use malloc.
+enum class NumaPlacement {
+    Local,      // kernel default: pages land on the node that first touches them
+    Interleave, // spread pages round-robin over all nodes
+    Bind        // keep pages on g_bigMemory.bindNode
+};
+
+struct BigMemoryConfig {
+    bool hugePages = true;
+    NumaPlacement placement = NumaPlacement::Local;
+    int bindNode = 0;
+};
+
+BigMemoryConfig g_bigMemory;
+thread_local int t_bindNode = -1; // set while building a per-node replica
+
+const size_t BIG_ARRAY_THRESHOLD = 2 * 1024 * 1024;
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Linux mbind() modes (see linux/mempolicy.h)
+const int MPOL_BIND_MODE = 2;
+const int MPOL_INTERLEAVE_MODE = 3;
+
+// Live big mappings, so usage can be reported per kind of page
+struct BigMapping {
+    size_t length;
+    bool hugetlb;    // explicit huge pages
+    bool advised;    // normal pages advised for transparent huge pages
+};
+
+mutex g_bigMappingsLock;
+unordered_map<void *, BigMapping> g_bigMappings;
+
+// Number of NUMA nodes (1 if the machine does not report any).
+int numaNodeCount() {
+    static int count = [] {
+        ifstream online("/sys/devices/system/node/online");
+        string ranges;
+        if (!(online >> ranges)) return 1;
+        int highest = 0;
+        for (const string &range : splitFields(ranges, ',')) {
+            size_t dash = range.find('-');
+            highest = max(highest, atoi(range.c_str() + (dash == string::npos ? 0 : dash + 1)));
+        }
+        return highest + 1;
+    }();
+    return count;
+}
+
+// NUMA node of each CPU, read once from /sys/devices/system/node/node<N>/cpulist.
+const vector<int> &cpuNodes() {
+    static vector<int> nodes = [] {
+        vector<int> table;
+        for (int node = 0; node < numaNodeCount(); ++node) {
+            ifstream list("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+            string ranges;
+            if (!(list >> ranges)) continue;
+            for (const string &range : splitFields(ranges, ',')) {
+                size_t dash = range.find('-');
+                int first = atoi(range.c_str());
+                int last = atoi(range.c_str() + (dash == string::npos ? 0 : dash + 1));
+                if (last >= static_cast<int>(table.size())) table.resize(last + 1, 0);
+                for (int cpu = first; cpu <= last; ++cpu) table[cpu] = node;
+            }
         }
+        return table;
+    }();
+    return nodes;
+}
+
+// NUMA node of the CPU this thread is running on. Threads rarely move
+// between nodes, so the answer is cached per thread and refreshed every
+// 1024 calls; sched_getcpu() itself goes through the vDSO, not a syscall.
+int currentNumaNode() {
+    if (numaNodeCount() == 1) return 0;
+    thread_local int node = 0;
+    thread_local unsigned calls = 0;
+    if (calls++ % 1024 == 0) {
+        int cpu = sched_getcpu();
+        const vector<int> &table = cpuNodes();
+        node = (cpu >= 0 && cpu < static_cast<int>(table.size())) ? table[cpu] : 0;
     }
+    return node;
 }
 
-// --------- Binary search by ID (sorted by id) ---------
-int binarySearchById(const vector<Student> &students, int targetId, int &steps) {
-    int left = 0;
-    int right = static_cast<int>(students.size()) - 1;
-    steps = 0;
+// Apply the configured placement to a fresh (untouched) mapping.
+void placeOnNodes(void *memory, size_t bytes) {
+    int nodes = numaNodeCount();
+    if (nodes == 1 || nodes > 64) return;
 
-    while (left <= right) {
-        steps++;  // Increment steps on each check
-        int mid = left + (right - left) / 2;
-        if (students[mid].id == targetId) {
-            return mid;
-        } else if (targetId < students[mid].id) {
-            right = mid - 1;
+    int mode;
+    unsigned long mask;
+    if (t_bindNode >= 0) {
+        mode = MPOL_BIND_MODE;
+        mask = 1ul << t_bindNode;
+    } else if (g_bigMemory.placement == NumaPlacement::Interleave) {
+        mode = MPOL_INTERLEAVE_MODE;
+        mask = (nodes == 64) ? ~0ul : (1ul << nodes) - 1;
+    } else if (g_bigMemory.placement == NumaPlacement::Bind) {
+        mode = MPOL_BIND_MODE;
+        mask = 1ul << g_bigMemory.bindNode;
+    } else {
+        return;
+    }
+    // Failure only loses the placement hint, never the memory.
+    syscall(SYS_mbind, memory, bytes, mode, &mask, static_cast<unsigned long>(nodes + 1), 0ul);
+}
+
+void *allocateBigArray(size_t bytes) {
+    // malloc cannot place memory on a node, so small arrays of a per-node
+    // replica get pages of their own too.
+    bool small = bytes < BIG_ARRAY_THRESHOLD;
+    if (small && (t_bindNode < 0 || numaNodeCount() == 1)) {
+        void *memory = malloc(bytes);
+        if (memory == nullptr) throw bad_alloc();
+        return memory;
+    }
+
+    size_t unit = small ? static_cast<size_t>(sysconf(_SC_PAGESIZE)) : HUGE_PAGE_SIZE;
+    BigMapping mapping{(max<size_t>(bytes, 1) + unit - 1) / unit * unit, false, false};
+    void *memory = MAP_FAILED;
+    if (g_bigMemory.hugePages && !small) {
+        memory = mmap(nullptr, mapping.length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        mapping.hugetlb = (memory != MAP_FAILED);
+    }
+    if (memory == MAP_FAILED) {
+        memory = mmap(nullptr, mapping.length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) throw bad_alloc();
+        mapping.advised = g_bigMemory.hugePages && !small && madvise(memory, mapping.length, MADV_HUGEPAGE) == 0;
+    }
+    placeOnNodes(memory, mapping.length);
+
+    lock_guard<mutex> lock(g_bigMappingsLock);
+    g_bigMappings[memory] = mapping;
+    return memory;
+}
+
+void freeBigArray(void *memory, size_t bytes) {
+    // Small arrays are mapped only when bound to a node, which needs more than one
+    if (bytes < BIG_ARRAY_THRESHOLD && numaNodeCount() == 1) {
+        free(memory);
+        return;
+    }
+    size_t length;
+    {
+        lock_guard<mutex> lock(g_bigMappingsLock);
+        auto it = g_bigMappings.find(memory);
+        if (it == g_bigMappings.end()) {
+            free(memory); // a small array from malloc
+            return;
+        }
+        length = it->second.length;
+        g_bigMappings.erase(it);
+    }
+    munmap(memory, length);
+}
+
+// Bytes currently mapped for big arrays, by kind of page
+void bigArrayUsage(size_t &hugetlb, size_t &advised, size_t &plain) {
+    hugetlb = advised = plain = 0;
+    lock_guard<mutex> lock(g_bigMappingsLock);
+    for (const auto &entry : g_bigMappings) {
+        const BigMapping &m = entry.second;
+        (m.hugetlb ? hugetlb : m.advised ? advised : plain) += m.length;
+    }
+}
+
+// Standard allocator over allocateBigArray, for vectors that get large.
+template <typename T>
+struct BigArrayAllocator {
+    using value_type = T;
+
+    BigArrayAllocator() = default;
+    template <typename U>
+    BigArrayAllocator(const BigArrayAllocator<U> &) {}
+
+    T *allocate(size_t n) { return static_cast<T *>(allocateBigArray(n * sizeof(T))); }
+    void deallocate(T *p, size_t n) { freeBigArray(p, n * sizeof(T)); }
+};
+
+template <typename T, typename U>
+bool operator==(const BigArrayAllocator<T> &, const BigArrayAllocator<U> &) { return true; }
+template <typename T, typename U>
+bool operator!=(const BigArrayAllocator<T> &, const BigArrayAllocator<U> &) { return false; }
+
+// Parse --numa=local|interleave|bind:<node>; false if not understood.
+bool parseNumaOption(const string &value) {
+    if (value == "local") {
+        g_bigMemory.placement = NumaPlacement::Local;
+    } else if (value == "interleave") {
+        g_bigMemory.placement = NumaPlacement::Interleave;
+    } else if (value.rfind("bind:", 0) == 0) {
+        g_bigMemory.placement = NumaPlacement::Bind;
+        g_bigMemory.bindNode = atoi(value.c_str() + 5);
+        if (g_bigMemory.bindNode < 0 || g_bigMemory.bindNode >= numaNodeCount()) return false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// The sorted student array itself
+using StudentArray = vector<Student, BigArrayAllocator<Student>>;
+
+// --------- Average of the subjects that have a mark (false if none) ---------
+bool averageMark(const SubjectList &subjects, double &average) {
+    double sum = 0.0;
+    int count = 0;
+    for (const SubjectRecord &sub : subjects) {
+        if (sub.hasMark) {
+            sum += sub.mark;
+            count++;
+        }
+    }
+    if (count == 0) return false;
+    average = sum / count;
+    return true;
+}
+
+// --------- Ranking tree: order-statistic treap of (average, id) ---------
+// Ordered best first (higher average, then lower ID). Every node stores the
+// size of its subtree, so rank, top-k and insert/erase are all O(log n).
+class RankingTree {
+private:
+    struct Node {
+        double average;
+        int id;
+        unsigned priority;
+        int size;
+        Node *left;
+        Node *right;
+    };
+
+    Node *m_root = nullptr;
+    unsigned m_seed = 2463534242u;
+
+    static int sizeOf(Node *n) { return n != nullptr ? n->size : 0; }
+
+    static void update(Node *n) {
+        n->size = 1 + sizeOf(n->left) + sizeOf(n->right);
+    }
+
+    // Does (a1, id1) rank ahead of (a2, id2)?
+    static bool ahead(double a1, int id1, double a2, int id2) {
+        return a1 > a2 || (a1 == a2 && id1 < id2);
+    }
+
+    unsigned nextPriority() {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+        return m_seed;
+    }
+
+    // Split into nodes ranked ahead of (average, id) and the rest.
+    static void split(Node *n, double average, int id, Node *&front, Node *&back) {
+        if (n == nullptr) {
+            front = back = nullptr;
+        } else if (ahead(n->average, n->id, average, id)) {
+            split(n->right, average, id, n->right, back);
+            front = n;
+            update(front);
+        } else {
+            split(n->left, average, id, front, n->left);
+            back = n;
+            update(back);
+        }
+    }
+
+    static Node *merge(Node *front, Node *back) {
+        if (front == nullptr) return back;
+        if (back == nullptr) return front;
+        if (front->priority > back->priority) {
+            front->right = merge(front->right, back);
+            update(front);
+            return front;
+        }
+        back->left = merge(front, back->left);
+        update(back);
+        return back;
+    }
+
+    static Node *erase(Node *n, double average, int id) {
+        if (n == nullptr) return nullptr;
+        if (n->id == id && n->average == average) {
+            Node *joined = merge(n->left, n->right);
+            delete n;
+            return joined;
+        }
+        if (ahead(average, id, n->average, n->id)) n->left = erase(n->left, average, id);
+        else n->right = erase(n->right, average, id);
+        update(n);
+        return n;
+    }
+
+    static void collect(Node *n, size_t k, vector<pair<int, double>> &out) {
+        if (n == nullptr || out.size() >= k) return;
+        collect(n->left, k, out);
+        if (out.size() < k) out.push_back({n->id, n->average});
+        collect(n->right, k, out);
+    }
+
+    static void destroy(Node *n) {
+        if (n == nullptr) return;
+        destroy(n->left);
+        destroy(n->right);
+        delete n;
+    }
+
+    static size_t nodeBytes(const Node *n) {
+        if (n == nullptr) return 0;
+        return heapBlockBytes(n) + nodeBytes(n->left) + nodeBytes(n->right);
+    }
+
+public:
+    RankingTree() = default;
+    RankingTree(const RankingTree &) = delete;
+    RankingTree &operator=(const RankingTree &) = delete;
+
+    ~RankingTree() {
+        destroy(m_root);
+    }
+
+    int size() const { return sizeOf(m_root); }
+
+    void insert(double average, int id) {
+        Node *front;
+        Node *back;
+        split(m_root, average, id, front, back);
+        Node *n = new Node{average, id, nextPriority(), 1, nullptr, nullptr};
+        m_root = merge(merge(front, n), back);
+    }
+
+    void erase(double average, int id) {
+        m_root = erase(m_root, average, id);
+    }
+
+    // 1-based rank of (average, id)
+    int rankOf(double average, int id) const {
+        int rank = 1;
+        Node *n = m_root;
+        while (n != nullptr) {
+            if (ahead(n->average, n->id, average, id)) {
+                rank += sizeOf(n->left) + 1;
+                n = n->right;
+            } else {
+                n = n->left;
+            }
+        }
+        return rank;
+    }
+
+    // Best k as (id, average), best first
+    vector<pair<int, double>> top(size_t k) const {
+        vector<pair<int, double>> out;
+        collect(m_root, k, out);
+        return out;
+    }
+
+    size_t bytes() const { return sizeof(*this) + nodeBytes(m_root); }
+};
+
+// --------- Rankings of every course, kept current as marks change ---------
+class CourseRankings {
+private:
+    mutable shared_mutex m_lock;
+    unordered_map<string, unique_ptr<RankingTree>> m_byCourse;
+    unordered_map<int, double> m_averageOf; // ranked students only
+
+public:
+    // Record a student's new average (or remove them if they have no marks).
+    void update(int id, const string &course, const SubjectList &subjects) {
+        double average;
+        bool ranked = averageMark(subjects, average);
+
+        unique_lock<shared_mutex> lock(m_lock);
+        unique_ptr<RankingTree> &tree = m_byCourse[course];
+        if (!tree) tree.reset(new RankingTree());
+
+        auto old = m_averageOf.find(id);
+        if (old != m_averageOf.end()) {
+            tree->erase(old->second, id);
+            m_averageOf.erase(old);
+        }
+        if (ranked) {
+            tree->insert(average, id);
+            m_averageOf[id] = average;
+        }
+    }
+
+    // Rank and course size for a student; false if the student is not ranked.
+    bool rankOf(int id, const string &course, int &rank, int &outOf) const {
+        shared_lock<shared_mutex> lock(m_lock);
+        auto avg = m_averageOf.find(id);
+        auto tree = m_byCourse.find(course);
+        if (avg == m_averageOf.end() || tree == m_byCourse.end()) return false;
+        rank = tree->second->rankOf(avg->second, id);
+        outOf = tree->second->size();
+        return true;
+    }
+
+    vector<pair<int, double>> top(const string &course, size_t k) const {
+        shared_lock<shared_mutex> lock(m_lock);
+        auto tree = m_byCourse.find(course);
+        if (tree == m_byCourse.end()) return {};
+        return tree->second->top(k);
+    }
+
+    int rankedCount(const string &course) const {
+        shared_lock<shared_mutex> lock(m_lock);
+        auto tree = m_byCourse.find(course);
+        return tree == m_byCourse.end() ? 0 : tree->second->size();
+    }
+
+    // Bytes held by the trees and both maps. Map nodes are sized from their
+    // contents (key, value, next link, cached hash for string keys).
+    size_t bytes() const {
+        shared_lock<shared_mutex> lock(m_lock);
+        size_t total = (m_byCourse.bucket_count() + m_averageOf.bucket_count()) * sizeof(void *);
+        for (const auto &entry : m_byCourse) {
+            total += sizeof(void *) + sizeof(entry) + sizeof(size_t) + MALLOC_CHUNK_HEADER;
+            if (entry.first.capacity() > 15) total += entry.first.capacity() + 1 + MALLOC_CHUNK_HEADER;
+            total += entry.second->bytes() + MALLOC_CHUNK_HEADER;
+        }
+        total += m_averageOf.size() * (sizeof(void *) + sizeof(pair<const int, double>) + MALLOC_CHUNK_HEADER);
+        return total;
+    }
+};
+
+CourseRankings g_rankings;
+
+// --------- Bit-packed ID blocks (ID column and posting lists) ---------
+// A block is 128 sorted IDs stored as deltas from the block's first ID, each
+// in `bits` bits. Deltas are packed "vertically" across 4 lanes: value i
+// lives in lane i % 4, so one 128-bit load yields the next word of all four
+// lanes and SSE2 shifts unpack four IDs at a time.
+const int ID_BLOCK = 128;
+const int ID_LANES = 4;
+
+int bitsFor(uint32_t value) {
+    int bits = 0;
+    while (bits < 32 && (value >> bits) != 0) bits++;
+    return bits;
+}
+
+// Append one block of deltas (each < 2^bits) to words: `bits` words per lane.
+template <typename Words>
+void packIdBlock(const uint32_t *deltas, int bits, Words &words) {
+    size_t start = words.size();
+    words.resize(start + static_cast<size_t>(bits) * ID_LANES, 0);
+    for (int i = 0; i < ID_BLOCK && bits > 0; ++i) {
+        int lane = i % ID_LANES;
+        int bit = (i / ID_LANES) * bits;
+        uint64_t value = static_cast<uint64_t>(deltas[i]) << (bit % 32);
+        words[start + (bit / 32) * ID_LANES + lane] |= static_cast<uint32_t>(value);
+        if (bit % 32 + bits > 32) {
+            words[start + (bit / 32 + 1) * ID_LANES + lane] |= static_cast<uint32_t>(value >> 32);
+        }
+    }
+}
+
+// Decode a whole block (all 128 slots) back into IDs.
+void unpackIdBlock(const uint32_t *words, int bits, int base, int *out) {
+    if (bits == 0) {
+        for (int i = 0; i < ID_BLOCK; ++i) out[i] = base;
+        return;
+    }
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi32(bits == 32 ? -1 : static_cast<int>((1u << bits) - 1));
+    const __m128i vbase = _mm_set1_epi32(base);
+    __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words));
+    int word = 0;
+    int shift = 0;
+
+    for (int k = 0; k < ID_BLOCK / ID_LANES; ++k) {
+        __m128i delta = _mm_srl_epi32(current, _mm_cvtsi32_si128(shift));
+        shift += bits;
+        if (shift >= 32) {
+            shift -= 32;
+            if (++word < bits) {
+                __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words + word * ID_LANES));
+                if (shift > 0) delta = _mm_or_si128(delta, _mm_sll_epi32(next, _mm_cvtsi32_si128(bits - shift)));
+                current = next;
+            }
+        }
+        __m128i id = _mm_add_epi32(_mm_and_si128(delta, mask), vbase);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + k * ID_LANES), id);
+    }
+#else
+    uint64_t mask = (bits == 32) ? 0xFFFFFFFFull : ((1ull << bits) - 1);
+    for (int i = 0; i < ID_BLOCK; ++i) {
+        int lane = i % ID_LANES;
+        int bit = (i / ID_LANES) * bits;
+        uint64_t pair = words[(bit / 32) * ID_LANES + lane];
+        if (bit % 32 + bits > 32) pair |= static_cast<uint64_t>(words[(bit / 32 + 1) * ID_LANES + lane]) << 32;
+        out[i] = static_cast<int>(static_cast<uint32_t>(base) + static_cast<uint32_t>((pair >> (bit % 32)) & mask));
+    }
+#endif
+}
+
+// --------- Sorted ID set operations ---------
+// Append the IDs found in both sorted, duplicate-free arrays to out. With
+// SSE2, four IDs of a are compared against four of b at once (b rotated
+// three times), then the block with the smaller last ID is skipped.
+void intersectSorted(const int *a, size_t na, const int *b, size_t nb, vector<int> &out) {
+    size_t i = 0;
+    size_t j = 0;
+#if defined(__SSE2__)
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(hits));
+        while (mask != 0) {
+            out.push_back(a[i + __builtin_ctz(mask)]);
+            mask &= mask - 1;
+        }
+        int lastA = a[i + 3];
+        int lastB = b[j + 3];
+        if (lastA <= lastB) i += 4;
+        if (lastB <= lastA) j += 4;
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (b[j] < a[i]) {
+            j++;
+        } else {
+            out.push_back(a[i]);
+            i++;
+            j++;
+        }
+    }
+}
+
+vector<int> intersectIds(const vector<int> &a, const vector<int> &b) {
+    vector<int> out;
+    out.reserve(min(a.size(), b.size()));
+    intersectSorted(a.data(), a.size(), b.data(), b.size(), out);
+    return out;
+}
+
+vector<int> uniteIds(const vector<int> &a, const vector<int> &b) {
+    vector<int> out;
+    out.reserve(a.size() + b.size());
+    set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(out));
+    return out;
+}
+
+vector<int> subtractIds(const vector<int> &a, const vector<int> &b) {
+    vector<int> out;
+    out.reserve(a.size());
+    set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(out));
+    return out;
+}
+
+// --------- Posting list: compressed sorted IDs of one course or subject ---------
+// The bulk of the list is bit-packed in blocks with a skip index of block
+// minima and maxima. Recent additions and removals are kept in two small
+// sorted arrays and folded in once they reach 1/8 of the list.
+class PostingList {
+private:
+    vector<int> m_blockMin;
+    vector<int> m_blockMax;
+    vector<uint8_t> m_bitWidth;
+    vector<uint32_t> m_blockWords;  // first packed word of each block
+    vector<uint32_t> m_words;
+    size_t m_packed = 0;            // IDs in the packed blocks
+
+    vector<int> m_added;            // not in the packed blocks
+    vector<int> m_removed;          // in the packed blocks but no longer in the list
+
+    size_t blockLength(size_t b) const {
+        return min<size_t>(ID_BLOCK, m_packed - b * ID_BLOCK);
+    }
+
+    void decodeBlock(size_t b, int *out) const {
+        unpackIdBlock(m_words.data() + m_blockWords[b], m_bitWidth[b], m_blockMin[b], out);
+    }
+
+    bool packedContains(int id) const {
+        auto it = upper_bound(m_blockMin.begin(), m_blockMin.end(), id);
+        if (it == m_blockMin.begin()) return false;
+        size_t b = static_cast<size_t>(it - m_blockMin.begin()) - 1;
+        if (id > m_blockMax[b]) return false;
+        int block[ID_BLOCK];
+        decodeBlock(b, block);
+        return binary_search(block, block + blockLength(b), id);
+    }
+
+    // IDs of the packed blocks that are also in candidates (sorted). Only
+    // blocks whose [min, max] range holds a candidate are decoded.
+    void intersectPacked(const vector<int> &candidates, vector<int> &out) const {
+        int block[ID_BLOCK];
+        size_t b = 0;
+        size_t c = 0;
+        while (c < candidates.size()) {
+            b = static_cast<size_t>(lower_bound(m_blockMax.begin() + b, m_blockMax.end(), candidates[c]) -
+                                    m_blockMax.begin());
+            if (b == m_blockMax.size()) return;
+            if (m_blockMin[b] > candidates[c]) {
+                c = static_cast<size_t>(lower_bound(candidates.begin() + c, candidates.end(), m_blockMin[b]) -
+                                        candidates.begin());
+                continue;
+            }
+            size_t end = static_cast<size_t>(upper_bound(candidates.begin() + c, candidates.end(), m_blockMax[b]) -
+                                             candidates.begin());
+            decodeBlock(b, block);
+            intersectSorted(block, blockLength(b), candidates.data() + c, end - c, out);
+            c = end;
+            b++;
+        }
+    }
+
+    void pack(const vector<int> &ids) {
+        m_blockMin.clear();
+        m_blockMax.clear();
+        m_bitWidth.clear();
+        m_blockWords.clear();
+        m_words.clear();
+        m_packed = ids.size();
+
+        uint32_t deltas[ID_BLOCK];
+        for (size_t first = 0; first < ids.size(); first += ID_BLOCK) {
+            size_t length = min<size_t>(ID_BLOCK, ids.size() - first);
+            int base = ids[first];
+            // Pad a short last block with its last ID; only `length` are ever read.
+            for (size_t i = 0; i < ID_BLOCK; ++i) {
+                deltas[i] = static_cast<uint32_t>(ids[first + min(i, length - 1)]) - static_cast<uint32_t>(base);
+            }
+            int bits = bitsFor(deltas[ID_BLOCK - 1]);
+            m_blockMin.push_back(base);
+            m_blockMax.push_back(ids[first + length - 1]);
+            m_bitWidth.push_back(static_cast<uint8_t>(bits));
+            m_blockWords.push_back(static_cast<uint32_t>(m_words.size()));
+            packIdBlock(deltas, bits, m_words);
+        }
+        m_added.clear();
+        m_removed.clear();
+    }
+
+    void compactIfNeeded() {
+        if (m_added.size() + m_removed.size() > max<size_t>(64, m_packed / 8)) pack(ids());
+    }
+
+public:
+    size_t size() const { return m_packed + m_added.size() - m_removed.size(); }
+
+    bool contains(int id) const {
+        if (binary_search(m_added.begin(), m_added.end(), id)) return true;
+        if (binary_search(m_removed.begin(), m_removed.end(), id)) return false;
+        return packedContains(id);
+    }
+
+    void add(int id) {
+        auto removed = lower_bound(m_removed.begin(), m_removed.end(), id);
+        if (removed != m_removed.end() && *removed == id) {
+            m_removed.erase(removed);
+            return;
+        }
+        auto added = lower_bound(m_added.begin(), m_added.end(), id);
+        if (added != m_added.end() && *added == id) return;
+        if (packedContains(id)) return;
+        m_added.insert(added, id);
+        compactIfNeeded();
+    }
+
+    void remove(int id) {
+        auto added = lower_bound(m_added.begin(), m_added.end(), id);
+        if (added != m_added.end() && *added == id) {
+            m_added.erase(added);
+            return;
+        }
+        auto removed = lower_bound(m_removed.begin(), m_removed.end(), id);
+        if (removed != m_removed.end() && *removed == id) return;
+        if (!packedContains(id)) return;
+        m_removed.insert(removed, id);
+        compactIfNeeded();
+    }
+
+    // Every ID in the list, sorted.
+    vector<int> ids() const {
+        vector<int> packed(m_blockMin.size() * ID_BLOCK);
+        for (size_t b = 0; b < m_blockMin.size(); ++b) decodeBlock(b, packed.data() + b * ID_BLOCK);
+        packed.resize(m_packed);
+        return uniteIds(subtractIds(packed, m_removed), m_added);
+    }
+
+    // IDs of the list that are also in candidates (sorted).
+    vector<int> intersect(const vector<int> &candidates) const {
+        vector<int> packed;
+        intersectPacked(candidates, packed);
+        return uniteIds(subtractIds(packed, m_removed), intersectIds(m_added, candidates));
+    }
+
+    size_t bytes() const {
+        return sizeof(*this) + (m_blockMin.capacity() + m_blockMax.capacity()) * sizeof(int) +
+               m_bitWidth.capacity() + (m_blockWords.capacity() + m_words.capacity()) * sizeof(uint32_t) +
+               (m_added.capacity() + m_removed.capacity()) * sizeof(int);
+    }
+};
+
+// --------- Cohort index: course and subject -> posting lists ---------
+// Answers "students in course X who take Y but have no mark in it yet"
+// from the posting lists alone: the smallest required list is decoded and
+// the others are intersected into it, decoding only the blocks that can
+// match. Kept current by every insert and every mark commit.
+struct CohortQuery {
+    string course;              // empty: any course
+    vector<string> takes;       // enrolled in all of these
+    vector<string> marked;      // has a mark in all of these
+    vector<string> unmarked;    // enrolled in these but no mark yet
+    vector<string> anyOf;       // enrolled in at least one of these (ignored if empty)
+};
+
+class CohortIndex {
+private:
+    mutable shared_mutex m_lock;
+    unordered_map<string, PostingList> m_byCourse;
+    unordered_map<string, PostingList> m_bySubject;
+    unordered_map<string, PostingList> m_markedBySubject;
+
+    static const PostingList *lookup(const unordered_map<string, PostingList> &lists, const string &key) {
+        auto it = lists.find(key);
+        return it == lists.end() ? nullptr : &it->second;
+    }
+
+public:
+    void addStudent(int id, const string &course, const SubjectList &subjects) {
+        unique_lock<shared_mutex> lock(m_lock);
+        m_byCourse[course].add(id);
+        for (const SubjectRecord &sub : subjects) {
+            string name = sub.name.str();
+            m_bySubject[name].add(id);
+            if (sub.hasMark) m_markedBySubject[name].add(id);
+        }
+    }
+
+    void updateMarks(int id, const SubjectList &subjects) {
+        unique_lock<shared_mutex> lock(m_lock);
+        for (const SubjectRecord &sub : subjects) {
+            if (sub.hasMark) m_markedBySubject[sub.name.str()].add(id);
+            else m_markedBySubject[sub.name.str()].remove(id);
+        }
+    }
+
+    // Sorted IDs of the students matching every part of the query.
+    vector<int> run(const CohortQuery &query) const {
+        shared_lock<shared_mutex> lock(m_lock);
+
+        vector<const PostingList *> required;
+        bool unknown = false;
+        auto require = [&](const unordered_map<string, PostingList> &lists, const string &key) {
+            const PostingList *list = lookup(lists, key);
+            if (list == nullptr) unknown = true;
+            else required.push_back(list);
+        };
+        if (!query.course.empty()) require(m_byCourse, query.course);
+        for (const string &s : query.takes) require(m_bySubject, s);
+        for (const string &s : query.marked) require(m_markedBySubject, s);
+        for (const string &s : query.unmarked) require(m_bySubject, s);
+        if (unknown) return {};
+
+        vector<int> anyOf;
+        for (const string &s : query.anyOf) {
+            const PostingList *list = lookup(m_bySubject, s);
+            if (list != nullptr) anyOf = uniteIds(anyOf, list->ids());
+        }
+        if (required.empty() && query.anyOf.empty()) return {};
+
+        // Start from the smallest list so every later step works on few IDs
+        sort(required.begin(), required.end(),
+             [](const PostingList *a, const PostingList *b) { return a->size() < b->size(); });
+        vector<int> result;
+        if (required.empty()) {
+            result = move(anyOf);
+        } else {
+            result = required[0]->ids();
+            for (size_t i = 1; i < required.size() && !result.empty(); ++i) {
+                result = required[i]->intersect(result);
+            }
+            if (!query.anyOf.empty()) result = intersectIds(result, anyOf);
+        }
+
+        for (const string &s : query.unmarked) {
+            const PostingList *marked = lookup(m_markedBySubject, s);
+            if (marked != nullptr && !result.empty()) result = subtractIds(result, marked->intersect(result));
+        }
+        return result;
+    }
+
+    // Bytes of all lists; map nodes are sized from their contents.
+    size_t bytes() const {
+        shared_lock<shared_mutex> lock(m_lock);
+        size_t total = 0;
+        for (const auto *lists : {&m_byCourse, &m_bySubject, &m_markedBySubject}) {
+            total += lists->bucket_count() * sizeof(void *);
+            for (const auto &entry : *lists) {
+                total += sizeof(void *) + sizeof(size_t) + MALLOC_CHUNK_HEADER + sizeof(string) + entry.second.bytes();
+                if (entry.first.capacity() > 15) total += entry.first.capacity() + 1 + MALLOC_CHUNK_HEADER;
+            }
+        }
+        return total;
+    }
+};
+
+CohortIndex g_cohorts;
+
+// --------- Latency flight recorder ---------
+// Every add, find and set-marks is timed, always, so a slow operation can
+// still be looked at after it happened. Each thread records into its own
+// histograms without locking; a report adds them up. The histograms are
+// HDR-style: exact below 64 ns, then 32 buckets per power of two, so every
+// latency is kept to within about 3%. Each thread also keeps its slowest
+// operations with the student ID and step count, for a text report or a
+// Chrome trace file (open in chrome://tracing or ui.perfetto.dev).
+enum class Operation { Add, Find, SetMarks };
+const int OPERATION_COUNT = 3;
+
+const char *operationName(Operation op) {
+    switch (op) {
+        case Operation::Add: return "add";
+        case Operation::Find: return "find";
+        case Operation::SetMarks: return "set-marks";
+    }
+    return "?";
+}
+
+// Counts of one or more histograms, added up for reporting
+struct LatencySummary {
+    vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+
+    double meanNs() const { return count == 0 ? 0.0 : static_cast<double>(totalNs) / count; }
+
+    // Latency that a fraction q of operations did not exceed
+    uint64_t percentile(double q) const;
+};
+
+class LatencyHistogram {
+public:
+    static const int EXACT = 64;        // one bucket per nanosecond below this
+    static const int SUB_BUCKETS = 32;  // per power of two above it
+    static const int MAX_SHIFT = 34;    // up to 2^40 ns (18 minutes); longer goes in the last bucket
+    static const int BUCKETS = EXACT + MAX_SHIFT * SUB_BUCKETS;
+
+    static int bucketFor(uint64_t ns) {
+        if (ns < EXACT) return static_cast<int>(ns);
+        int msb = 63 - __builtin_clzll(ns);
+        int shift = msb - 5; // keep the top 6 bits: 32 sub-buckets
+        if (shift > MAX_SHIFT) return BUCKETS - 1;
+        return EXACT + (shift - 1) * SUB_BUCKETS + static_cast<int>(ns >> shift) - SUB_BUCKETS;
+    }
+
+    // Largest latency that falls in the bucket
+    static uint64_t bucketTop(int bucket) {
+        if (bucket < EXACT) return bucket;
+        int shift = (bucket - EXACT) / SUB_BUCKETS + 1;
+        uint64_t top = (bucket - EXACT) % SUB_BUCKETS + SUB_BUCKETS;
+        return ((top + 1) << shift) - 1;
+    }
+
+    // Owner thread only. With a single writer a plain load and store is
+    // enough; the atomics only let reports read while it records.
+    void record(uint64_t ns) {
+        bump(m_counts[bucketFor(ns)], 1);
+        bump(m_count, 1);
+        bump(m_totalNs, ns);
+        if (ns > m_maxNs.load(memory_order_relaxed)) m_maxNs.store(ns, memory_order_relaxed);
+    }
+
+    // Any thread
+    void addTo(LatencySummary &summary) const {
+        summary.counts.resize(BUCKETS, 0);
+        for (int i = 0; i < BUCKETS; ++i) {
+            summary.counts[i] += m_counts[i].load(memory_order_relaxed);
+        }
+        summary.count += m_count.load(memory_order_relaxed);
+        summary.totalNs += m_totalNs.load(memory_order_relaxed);
+        summary.maxNs = max(summary.maxNs, m_maxNs.load(memory_order_relaxed));
+    }
+
+    // Only while the owner thread is not recording
+    void reset() {
+        for (auto &c : m_counts) c.store(0, memory_order_relaxed);
+        m_count.store(0, memory_order_relaxed);
+        m_totalNs.store(0, memory_order_relaxed);
+        m_maxNs.store(0, memory_order_relaxed);
+    }
+
+private:
+    static void bump(atomic<uint64_t> &counter, uint64_t by) {
+        counter.store(counter.load(memory_order_relaxed) + by, memory_order_relaxed);
+    }
+
+    atomic<uint64_t> m_counts[BUCKETS] = {};
+    atomic<uint64_t> m_count{0};
+    atomic<uint64_t> m_totalNs{0};
+    atomic<uint64_t> m_maxNs{0};
+};
+
+uint64_t LatencySummary::percentile(double q) const {
+    uint64_t rank = max<uint64_t>(static_cast<uint64_t>(q * count + 0.5), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) return min(LatencyHistogram::bucketTop(static_cast<int>(i)), maxNs);
+    }
+    return maxNs;
+}
+
+// One operation slow enough to be kept
+struct SlowOperation {
+    Operation op;
+    int id;
+    int steps;
+    uint64_t startNs;    // since the recorder was last reset
+    uint64_t durationNs;
+    int thread;          // recorder's own thread number
+};
+
+class FlightRecorder {
+public:
+    using Clock = chrono::steady_clock;
+    static const size_t SLOW_CAPACITY = 16; // slowest operations kept per thread
+
+    FlightRecorder() : m_startNs(Clock::now().time_since_epoch().count()) {}
+
+    void record(Operation op, int id, int steps, Clock::time_point start, Clock::time_point end) {
+        uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+        ThreadLog &log = local();
+        log.histograms[static_cast<int>(op)].record(ns);
+        if (ns <= log.slowThreshold.load(memory_order_relaxed)) {
+            return; // the common case: not among this thread's slowest
+        }
+
+        lock_guard<mutex> lock(log.slowLock);
+        long long started = chrono::duration_cast<chrono::nanoseconds>(start.time_since_epoch()).count() -
+                            m_startNs.load(memory_order_relaxed);
+        SlowOperation entry{op, id, steps, static_cast<uint64_t>(max(0LL, started)), ns, log.thread};
+        if (log.slowest.size() < SLOW_CAPACITY) {
+            log.slowest.push_back(entry);
+            if (log.slowest.size() < SLOW_CAPACITY) return;
+        } else {
+            *fastestSlow(log) = entry;
+        }
+        log.slowThreshold.store(fastestSlow(log)->durationNs, memory_order_relaxed);
+    }
+
+    // Forget everything recorded so far. Call only while no thread is
+    // running an operation.
+    void reset() {
+        lock_guard<mutex> lock(m_lock);
+        for (auto &log : m_threads) {
+            for (auto &h : log->histograms) h.reset();
+            lock_guard<mutex> slowLock(log->slowLock);
+            log->slowest.clear();
+            log->slowThreshold.store(0, memory_order_relaxed);
+        }
+        m_startNs.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+    }
+
+    // Histograms of every thread for one operation, merged
+    LatencySummary summary(Operation op) {
+        LatencySummary total;
+        lock_guard<mutex> lock(m_lock);
+        for (auto &log : m_threads) log->histograms[static_cast<int>(op)].addTo(total);
+        return total;
+    }
+
+    // Slowest operations kept by every thread, slowest first
+    vector<SlowOperation> slowest() {
+        vector<SlowOperation> all;
+        lock_guard<mutex> lock(m_lock);
+        for (auto &log : m_threads) {
+            lock_guard<mutex> slowLock(log->slowLock);
+            all.insert(all.end(), log->slowest.begin(), log->slowest.end());
+        }
+        sort(all.begin(), all.end(),
+             [](const SlowOperation &a, const SlowOperation &b) { return a.durationNs > b.durationNs; });
+        return all;
+    }
+
+    // Percentiles per operation, then the top slowest operations
+    void printReport(ostream &out, size_t top = 10) {
+        out << left << setw(10) << "Operation" << right << setw(10) << "Count" << setw(10) << "Mean"
+            << setw(10) << "p50" << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "p99.9"
+            << setw(10) << "Max" << "  (ns)\n";
+        for (int i = 0; i < OPERATION_COUNT; ++i) {
+            Operation op = static_cast<Operation>(i);
+            LatencySummary s = summary(op);
+            out << left << setw(10) << operationName(op) << right << setw(10) << s.count
+                << setw(10) << static_cast<uint64_t>(s.meanNs()) << setw(10) << s.percentile(0.50)
+                << setw(10) << s.percentile(0.90) << setw(10) << s.percentile(0.99)
+                << setw(10) << s.percentile(0.999) << setw(10) << s.maxNs << "\n";
+        }
+
+        vector<SlowOperation> slow = slowest();
+        out << "Slowest operations:\n";
+        for (size_t i = 0; i < slow.size() && i < top; ++i) {
+            const SlowOperation &s = slow[i];
+            out << setw(4) << i + 1 << ". " << left << setw(10) << operationName(s.op) << right
+                << "ID " << setw(9) << s.id << "  steps " << setw(6) << s.steps
+                << "  " << setw(9) << s.durationNs << " ns  (thread " << s.thread << ")\n";
+        }
+    }
+
+    // Every kept slow operation as a complete event on its thread's track
+    void writeChromeTrace(ostream &out) {
+        vector<SlowOperation> slow = slowest();
+        size_t threads;
+        {
+            lock_guard<mutex> lock(m_lock);
+            threads = m_threads.size();
+        }
+
+        out << "{\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]() {
+            out << (first ? "" : ",\n");
+            first = false;
+        };
+        for (size_t t = 0; t < threads; ++t) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+        }
+        out << fixed << setprecision(3);
+        for (const SlowOperation &s : slow) {
+            separator();
+            out << "{\"name\":\"" << operationName(s.op) << "\",\"cat\":\"student-db\",\"ph\":\"X\",\"pid\":1"
+                << ",\"tid\":" << s.thread << ",\"ts\":" << s.startNs / 1000.0 << ",\"dur\":" << s.durationNs / 1000.0
+                << ",\"args\":{\"id\":" << s.id << ",\"steps\":" << s.steps << "}}";
+        }
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+private:
+    struct ThreadLog {
+        int thread = 0;
+        LatencyHistogram histograms[OPERATION_COUNT];
+        atomic<uint64_t> slowThreshold{0}; // fastest kept slow op, once the list is full
+        mutex slowLock;                    // the owner takes it only to keep a slow op
+        vector<SlowOperation> slowest;     // at most SLOW_CAPACITY, unordered
+    };
+
+    mutex m_lock; // guards m_threads
+    vector<unique_ptr<ThreadLog>> m_threads; // outlive their threads, for later reports
+    atomic<long long> m_startNs;
+
+    static SlowOperation *fastestSlow(ThreadLog &log) {
+        return &*min_element(log.slowest.begin(), log.slowest.end(),
+                             [](const SlowOperation &a, const SlowOperation &b) { return a.durationNs < b.durationNs; });
+    }
+
+    // This thread's log, created on its first operation
+    ThreadLog &local() {
+        thread_local ThreadLog *log = nullptr;
+        if (log == nullptr) {
+            lock_guard<mutex> lock(m_lock);
+            m_threads.push_back(make_unique<ThreadLog>());
+            log = m_threads.back().get();
+            log->thread = static_cast<int>(m_threads.size()) - 1;
+        }
+        return *log;
+    }
+};
+
+FlightRecorder g_flightRecorder;
+
+// Times one operation and hands it to the flight recorder when it goes out
+// of scope. steps is read then, so it covers the whole operation.
+class OperationTimer {
+public:
+    OperationTimer(Operation op, int id, const int &steps)
+        : m_op(op), m_id(id), m_steps(steps), m_start(FlightRecorder::Clock::now()) {}
+
+    ~OperationTimer() { g_flightRecorder.record(m_op, m_id, m_steps, m_start, FlightRecorder::Clock::now()); }
+
+    OperationTimer(const OperationTimer &) = delete;
+    OperationTimer &operator=(const OperationTimer &) = delete;
+
+private:
+    Operation m_op;
+    int m_id;
+    const int &m_steps;
+    FlightRecorder::Clock::time_point m_start;
+};
+
+// --------- Publish new marks and keep the course rankings and cohort index in step ---------
+uint64_t commitMarks(Student &s, SubjectList subjects) {
+    const int steps = 0; // finding the student was already recorded as a find
+    OperationTimer timer(Operation::SetMarks, s.id, steps);
+    g_rankings.update(s.id, s.course.str(), subjects);
+    g_cohorts.updateMarks(s.id, subjects);
+    return s.transcript.publish(move(subjects));
+}
+
+// --------- Helper: safely read an integer ---------
+int readInt(const string &prompt) {
+    int value;
+    while (true) {
+        cout << prompt;
+        if (cin >> value) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
+            return value;
+        } else {
+            cout << "Wrong input, please enter another input (integer).\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+}
+
+// --------- Helper: safely read a double ---------
+double readDouble(const string &prompt) {
+    double value;
+    while (true) {
+        cout << prompt;
+        if (cin >> value) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
+            return value;
+        } else {
+            cout << "Wrong input, please enter another input (number).\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+}
+
+// --------- Binary search by ID (sorted by id) ---------
+int binarySearchById(const StudentArray &students, int targetId, int &steps) {
+    int left = 0;
+    int right = static_cast<int>(students.size()) - 1;
+    steps = 0;
+
+    while (left <= right) {
+        steps++;  // Increment steps on each check
+        int mid = left + (right - left) / 2;
+        if (students[mid].id == targetId) {
+            return mid;
+        } else if (targetId < students[mid].id) {
+            right = mid - 1;
+        } else {
+            left = mid + 1;
+        }
+    }
+    return -1; // not found
+}
+
+// --------- Compressed ID column (read-optimized index over the sorted IDs) ---------
+// IDs are cut into blocks of 128. Each block keeps its first ID as a base
+// (frame of reference) and stores every ID as (id - base) in just enough
+// bits for the largest one. A lookup binary-searches the small skip index of
+// block minima, then decodes one block and finds the ID inside it.
+//
+// Blocks use the vertical 4-lane packing above, so SSE2 shifts unpack and
+// compare four IDs at a time.
+//
+// The column is an extra search index: every Student still holds its own
+// int ID, so dense IDs cost about 1.3 bytes each per NUMA copy on top of
+// the records, in exchange for a search that touches far less memory.
+class CompressedIdColumn {
+public:
+    static const int BLOCK = ID_BLOCK;
+    static const int LANES = ID_LANES;
+
+private:
+    vector<int, BigArrayAllocator<int>> m_blockMin;          // skip index: first ID of each block
+    vector<uint8_t, BigArrayAllocator<uint8_t>> m_bitWidth;  // bits per delta, per block
+    vector<size_t, BigArrayAllocator<size_t>> m_blockWords;  // first packed word of each block
+    vector<uint32_t, BigArrayAllocator<uint32_t>> m_words;   // packed deltas of all blocks
+    size_t m_count = 0;
+
+    // Search block b for target. Returns its offset in the block or -1.
+    // Decodes with unpackIdBlock, then compares four IDs at a time.
+    int searchBlock(size_t b, int target) const {
+        int bits = m_bitWidth[b];
+        int base = m_blockMin[b];
+        size_t length = min<size_t>(BLOCK, m_count - b * BLOCK);
+        if (bits == 0) return (target == base) ? 0 : -1; // block of one repeated ID
+        alignas(16) int ids[BLOCK];
+        unpackIdBlock(m_words.data() + m_blockWords[b], bits, base, ids);
+        int less = 0;   // IDs in the block below target (= target's offset)
+        int equal = 0;
+
+#if defined(__SSE2__)
+        const __m128i vtarget = _mm_set1_epi32(target);
+        for (int k = 0; k < BLOCK; k += LANES) {
+            __m128i id = _mm_load_si128(reinterpret_cast<const __m128i *>(ids + k));
+            less += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(id, vtarget))));
+            equal |= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(id, vtarget)));
+        }
+#else
+        for (int i = 0; i < BLOCK; ++i) {
+            if (ids[i] < target) less++;
+            if (ids[i] == target) equal = 1;
+        }
+#endif
+
+        if (!equal || static_cast<size_t>(less) >= length) return -1;
+        return less;
+    }
+
+public:
+    // Re-encode from the (sorted) students.
+    void build(const StudentArray &students) {
+        if (t_bindNode >= 0) {
+            // Reused buffers keep the node they were first placed on, so a
+            // replica always starts from fresh storage bound to its node.
+            decltype(m_blockMin)().swap(m_blockMin);
+            decltype(m_bitWidth)().swap(m_bitWidth);
+            decltype(m_blockWords)().swap(m_blockWords);
+            decltype(m_words)().swap(m_words);
+        }
+        m_count = students.size();
+        size_t blocks = (m_count + BLOCK - 1) / BLOCK;
+        m_blockMin.assign(blocks, 0);
+        m_bitWidth.assign(blocks, 0);
+        m_blockWords.assign(blocks, 0);
+        m_words.clear();
+
+        uint32_t deltas[BLOCK];
+        for (size_t b = 0; b < blocks; ++b) {
+            size_t first = b * BLOCK;
+            size_t length = min<size_t>(BLOCK, m_count - first);
+            int base = students[first].id;
+
+            // Pad a short last block with its last ID; that never changes a search result.
+            for (size_t i = 0; i < BLOCK; ++i) {
+                int id = students[first + min(i, length - 1)].id;
+                deltas[i] = static_cast<uint32_t>(id) - static_cast<uint32_t>(base);
+            }
+
+            int bits = bitsFor(deltas[BLOCK - 1]); // sorted, so the last delta is the largest
+            m_blockMin[b] = base;
+            m_bitWidth[b] = static_cast<uint8_t>(bits);
+            m_blockWords[b] = m_words.size();
+            packIdBlock(deltas, bits, m_words);
+        }
+    }
+
+    // Position of the ID in the sorted array, or -1. Steps counts skip-index
+    // probes plus one for the block decode.
+    int find(int targetId, int &steps) const {
+        steps = 0;
+        if (m_count == 0) return -1;
+
+        // Last block whose first ID is <= target
+        size_t left = 0;
+        size_t right = m_blockMin.size();
+        while (left < right) {
+            steps++;
+            size_t mid = left + (right - left) / 2;
+            if (m_blockMin[mid] <= targetId) left = mid + 1;
+            else right = mid;
+        }
+        if (left == 0) return -1;
+
+        size_t b = left - 1;
+        steps++;
+        int offset = searchBlock(b, targetId);
+        return offset == -1 ? -1 : static_cast<int>(b * BLOCK + offset);
+    }
+
+    size_t size() const { return m_count; }
+
+    // Bytes held by the column (skip index + packed data)
+    size_t bytes() const {
+        return m_blockMin.capacity() * sizeof(int) + m_bitWidth.capacity() +
+               m_blockWords.capacity() * sizeof(size_t) + m_words.capacity() * sizeof(uint32_t);
+    }
+};
+
+// One read-only copy of the column per NUMA node, each in that node's
+// memory, so lookups never cross the interconnect. One copy on most machines.
+vector<CompressedIdColumn> g_idColumns;
+bool g_idColumnStale = true; // set by every insert, cleared by a rebuild
+size_t g_staleLookups = 0;   // lookups since the last insert while stale
+
+void rebuildIdColumns(const StudentArray &students) {
+    g_idColumns.resize(numaNodeCount());
+    for (int node = 0; node < numaNodeCount(); ++node) {
+        if (numaNodeCount() > 1) t_bindNode = node;
+        g_idColumns[node].build(students);
+    }
+    t_bindNode = -1;
+}
+
+// --------- Hot-ID lookup cache (in front of the ID column) ---------
+// A few thousand active students get most lookups, so a small table of
+// ID -> array position answers them with one hash probe. Eviction is CLOCK:
+// every hit sets a reference bit and the hand evicts the first entry whose
+// bit is clear. An ID is only admitted on its second miss in a short window
+// (doorkeeper), so one-off lookups do not push hot students out.
+class HotIdCache {
+private:
+    struct Entry {
+        int id;
+        int slot;
+        bool used;
+        bool referenced;
+    };
+
+    vector<Entry> m_table;       // open addressing, linear probing, <= 50% full
+    vector<int> m_doorkeeper;    // last missed ID per hash bucket
+    vector<bool> m_doorkeeperSet;
+    size_t m_mask = 0;
+    size_t m_count = 0;
+    size_t m_capacity = 0;       // entries allowed before evicting
+    size_t m_hand = 0;           // CLOCK hand (table index)
+    bool m_enabled = true;
+
+    long long m_hits = 0;
+    long long m_misses = 0;
+    long long m_admissions = 0;
+    long long m_evictions = 0;
+
+    size_t bucketOf(int id) const {
+        return (static_cast<uint32_t>(id) * 2654435769u) & m_mask;
+    }
+
+    // Remove the entry at table index i and close the gap it leaves.
+    void eraseAt(size_t i) {
+        m_table[i].used = false;
+        m_count--;
+        size_t gap = i;
+        for (size_t j = (i + 1) & m_mask; m_table[j].used; j = (j + 1) & m_mask) {
+            size_t home = bucketOf(m_table[j].id);
+            // Move j back into the gap unless its home lies between gap and j
+            bool between = (gap <= j) ? (gap < home && home <= j) : (gap < home || home <= j);
+            if (!between) {
+                m_table[gap] = m_table[j];
+                m_table[j].used = false;
+                gap = j;
+            }
+        }
+    }
+
+    void evictOne() {
+        while (true) {
+            Entry &e = m_table[m_hand];
+            if (e.used) {
+                if (!e.referenced) {
+                    eraseAt(m_hand);
+                    m_evictions++;
+                    return;
+                }
+                e.referenced = false; // second chance
+            }
+            m_hand = (m_hand + 1) & m_mask;
+        }
+    }
+
+public:
+    explicit HotIdCache(size_t capacity) {
+        size_t tableSize = 1;
+        while (tableSize < capacity * 2) tableSize *= 2;
+        m_table.assign(tableSize, Entry{0, 0, false, false});
+        m_doorkeeper.assign(tableSize, 0);
+        m_doorkeeperSet.assign(tableSize, false);
+        m_mask = tableSize - 1;
+        m_capacity = capacity;
+    }
+
+    bool enabled() const { return m_enabled; }
+
+    void setEnabled(bool on) {
+        m_enabled = on;
+        if (!on) clear();
+    }
+
+    // Cached array position of the ID, if present.
+    bool lookup(int id, int &slot) {
+        for (size_t i = bucketOf(id); m_table[i].used; i = (i + 1) & m_mask) {
+            if (m_table[i].id == id) {
+                m_table[i].referenced = true;
+                slot = m_table[i].slot;
+                m_hits++;
+                return true;
+            }
+        }
+        m_misses++;
+        return false;
+    }
+
+    // Called after a miss was resolved by the full search.
+    void admit(int id, int slot) {
+        size_t door = bucketOf(id);
+        if (!m_doorkeeperSet[door] || m_doorkeeper[door] != id) {
+            m_doorkeeper[door] = id; // first miss: remember, do not cache yet
+            m_doorkeeperSet[door] = true;
+            return;
+        }
+        m_doorkeeperSet[door] = false;
+
+        if (m_count >= m_capacity) evictOne();
+        size_t i = bucketOf(id);
+        while (m_table[i].used) i = (i + 1) & m_mask;
+        m_table[i] = Entry{id, slot, true, false};
+        m_count++;
+        m_admissions++;
+    }
+
+    // A student was inserted at array position `position`: everyone at or
+    // after it moved one place right.
+    void onInsert(int position) {
+        for (Entry &e : m_table) {
+            if (e.used && e.slot >= position) e.slot++;
+        }
+    }
+
+    void clear() {
+        for (Entry &e : m_table) e.used = false;
+        m_doorkeeperSet.assign(m_doorkeeperSet.size(), false);
+        m_count = 0;
+    }
+
+    long long hits() const { return m_hits; }
+    long long misses() const { return m_misses; }
+
+    size_t bytes() const {
+        return m_table.capacity() * sizeof(Entry) + m_doorkeeper.capacity() * sizeof(int) +
+               m_doorkeeperSet.capacity() / 8;
+    }
+
+    double hitRatio() const {
+        long long total = m_hits + m_misses;
+        return total > 0 ? static_cast<double>(m_hits) / total : 0.0;
+    }
+
+    void printStats(ostream &out) const {
+        out << "Lookup cache : " << (m_enabled ? "on" : "off") << ", "
+            << m_count << "/" << m_capacity << " entries\n";
+        out << "Hits         : " << m_hits << "\n";
+        out << "Misses       : " << m_misses << "\n";
+        out << "Hit ratio    : " << hitRatio() * 100.0 << "%\n";
+        out << "Admissions   : " << m_admissions << ", evictions: " << m_evictions << "\n";
+    }
+
+    void resetStats() {
+        m_hits = m_misses = m_admissions = m_evictions = 0;
+    }
+};
+
+const size_t HOT_CACHE_ENTRIES = 4096;
+HotIdCache g_hotCache(HOT_CACHE_ENTRIES);
+
+// A rebuild costs a pass over every ID, so a stale column is only rebuilt
+// after this many lookups in a row with no insert between them.
+size_t idColumnRebuildThreshold(size_t students) {
+    return max<size_t>(256, students / 64);
+}
+
+// --------- Find a student's position through the compressed ID column ---------
+// Hot IDs are answered by the lookup cache. While students are being added
+// the column is stale and lookups binary-search the array itself; once
+// reads run long enough without inserts to pay for it, the column is
+// rebuilt. Not safe to call from several threads.
+int findStudentIndex(const StudentArray &students, int targetId, int &steps) {
+    OperationTimer timer(Operation::Find, targetId, steps);
+    if (g_hotCache.enabled()) {
+        int slot;
+        if (g_hotCache.lookup(targetId, slot)) {
+            steps = 1;
+            return slot;
+        }
+    }
+
+    if (g_idColumnStale && ++g_staleLookups >= idColumnRebuildThreshold(students.size())) {
+        rebuildIdColumns(students);
+        g_idColumnStale = false;
+    }
+    int index = g_idColumnStale ? binarySearchById(students, targetId, steps)
+                                : g_idColumns[currentNumaNode()].find(targetId, steps);
+
+    if (index != -1 && g_hotCache.enabled()) g_hotCache.admit(targetId, index);
+    return index;
+}
+
+// --------- Insert student sorted by ID (no output, false if ID exists) ---------
+bool addStudentSorted(StudentArray &students, Student &&newStudent) {
+    int steps = 0;
+    OperationTimer timer(Operation::Add, newStudent.id, steps);
+    auto pos = lower_bound(
+        students.begin(),
+        students.end(),
+        newStudent.id,
+        [&steps](const Student &s, int value) {
+            steps++;
+            return s.id < value;
+        }
+    );
+
+    if (pos != students.end() && pos->id == newStudent.id) {
+        return false;
+    }
+
+    g_hotCache.onInsert(static_cast<int>(pos - students.begin()));
+    pos = students.insert(pos, move(newStudent));
+    g_idColumnStale = true;
+    g_staleLookups = 0;
+
+    ReadSnapshot snap;
+    g_cohorts.addStudent(pos->id, pos->course.str(), pos->transcript.read(snap));
+    return true;
+}
+
+// --------- Insert student sorted by ID ---------
+void insertStudentSorted(StudentArray &students, Student &&newStudent) {
+    int id = newStudent.id;
+    if (!addStudentSorted(students, move(newStudent))) {
+        cout << "ID " << id << " already exists in the system.\n";
+        return;
+    }
+    cout << "Student with ID " << id << " has been added successfully.\n";
+}
+
+// --------- Show a single student's info ---------
+void showStudent(const Student &s, ostream &out = cout) {
+    ReadSnapshot snap; // the whole transcript comes from one version
+    const SubjectList &subjects = s.transcript.read(snap);
+
+    out << "\n=== Student Information ===\n";
+    out << "ID     : " << s.id << "\n";
+    out << "Name   : " << s.name << "\n";
+    out << "Course : " << s.course << "\n";
+    out << "Subjects and Marks:\n";
+
+    if (subjects.empty()) {
+        out << "  (No subjects registered)\n";
+    } else {
+        for (size_t i = 0; i < subjects.size(); ++i) {
+            out << "  " << (i + 1) << ". " << subjects[i].name << " - ";
+            if (subjects[i].hasMark) {
+                out << subjects[i].mark;
+            } else {
+                out << "(no mark yet)";
+            }
+            out << "\n";
+        }
+    }
+
+    int rank, outOf;
+    if (g_rankings.rankOf(s.id, s.course.str(), rank, outOf)) {
+        out << "Rank in course: " << rank << " of " << outOf
+            << " (top " << 100.0 * rank / outOf << "%)\n";
+    }
+
+    out << "===========================\n";
+}
+
+// --------- Menu display ---------
+void showMenu() {
+    cout << "\n==============================\n";
+    cout << "  Student ID Search System\n";
+    cout << "  (Sorted Array + Binary Search)\n";
+    cout << "==============================\n";
+    cout << "1. Enter new student\n";
+    cout << "2. Search student by ID\n";
+    cout << "3. Insert marks\n";
+    cout << "4. Run bulk jobs on all students\n";
+    cout << "5. Course rankings\n";
+    cout << "6. Lookup cache statistics\n";
+    cout << "7. Apply marks from a results file\n";
+    cout << "8. Memory usage report\n";
+    cout << "9. Cohort query (course and subjects)\n";
+    cout << "10. Operation latency report\n";
+    cout << "11. Exit\n";
+    cout << "Enter your choice: ";
+}
+
+// --------- Option 1: Enter new student (with many subjects) ---------
+void menuEnterNewStudent(StudentArray &students) {
+    while (true) {
+        Student s;
+        SubjectList subjects;
+
+        cout << "\n--- Enter New Student ---\n";
+        s.id = readInt("Enter student ID (integer): ");
+
+        string line;
+        cout << "Enter name   : ";
+        getline(cin, line);
+        s.name = line;
+
+        cout << "Enter course : ";
+        getline(cin, line);
+        s.course = line;
+
+        // Enter multiple subjects
+        cout << "\nNow enter subjects for this student.\n";
+        cout << "Press \"Enter\" to add new subject or press \"0\" when you are done.\n";
+
+        while (true) {
+            SubjectRecord sub;
+            cout << "Enter subject name (or 0 to finish): ";
+            getline(cin, line);
+            sub.name = line;
+
+            if (sub.name == "0") {
+                if (subjects.empty()) {
+                    cout << "Student must have at least one subject.\n";
+                    continue;
+                } else {
+                    break;
+                }
+            }
+
+            sub.hasMark = false;
+            sub.mark = 0.0;
+            subjects.push_back(move(sub));
+        }
+
+        s.transcript = VersionChain(move(subjects));
+        insertStudentSorted(students, move(s));
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Enter another student\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                // loop again to add another student
+                break;
+            } else if (choice == 2) {
+                return; // back to main menu
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 2: Search student by ID ---------
+void menuSearchStudent(const StudentArray &students) {
+    if (students.empty()) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Search Student by ID ---\n";
+        int targetId = readInt("Enter student ID to search: ");
+        int steps = 0; // Initialize steps counter
+
+        int index = findStudentIndex(students, targetId, steps);
+        if (index != -1) {
+            showStudent(students[index]);
+            cout << "Steps taken to find the student: " << steps << "\n";
+        } else {
+            cout << "ID " << targetId << " not found in the system.\n";
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Search another ID\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                // loop again to search another ID
+                break;
+            } else if (choice == 2) {
+                return; // back to main menu
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 3: Insert marks for subjects ---------
+void menuInsertMarks(StudentArray &students) {
+    if (students.empty()) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Insert Marks ---\n";
+        int targetId = readInt("Enter student ID to insert marks: ");
+
+        int steps = 0;
+        int index = findStudentIndex(students, targetId, steps);
+        if (index == -1) {
+            cout << "ID " << targetId << " not found in the system.\n";
+        } else {
+            Student &s = students[index];
+
+            // Work on a private copy; readers keep seeing the old version
+            // until the finished transcript is published in one step.
+            SubjectList updated;
+            {
+                ReadSnapshot snap;
+                updated = s.transcript.read(snap);
+            }
+
+            if (updated.empty()) {
+                cout << "This student has no subjects registered.\n";
+            } else {
+                cout << "\nInserting marks for student:\n";
+                showStudent(s);
+                cout << "\nEnter marks for each subject.\n";
+                cout << "(If you do not want to change a subject's mark, you can enter the same value again.)\n";
+
+                for (size_t i = 0; i < updated.size(); ++i) {
+                    cout << "\nSubject " << (i + 1) << ": " << updated[i].name << "\n";
+                    double mark = readDouble("Enter mark: ");
+                    updated[i].mark = mark;
+                    updated[i].hasMark = true;
+                }
+
+                uint64_t version = commitMarks(s, move(updated));
+                cout << "\nAll marks updated for this student (version " << version << ").\n";
+                showStudent(s);
+            }
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Insert marks for another ID\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                // loop again
+                break;
+            } else if (choice == 2) {
+                return;
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// ===================================================================
+// Work-stealing thread pool for bulk jobs over every student
+// ===================================================================
+//
+// Each worker owns a deque. It pushes and pops its own tasks at the back
+// and, when it runs dry, steals from the front of another worker's deque.
+// parallelFor splits a range in half repeatedly, keeping the left half and
+// pushing the right half, so the oldest (largest) chunks are the ones stolen.
+
+thread_local int t_poolWorker = -1; // index of the pool worker running this thread
+
+class WorkStealingPool {
+private:
+    struct Worker {
+        mutex lock;
+        deque<function<void()>> tasks;
+        thread runner;
+        atomic<long long> busyNs{0};  // time spent running chunks
+        atomic<long> executed{0};     // chunks run
+        atomic<long> stolen{0};       // tasks this worker took from others
+    };
+
+    vector<unique_ptr<Worker>> m_workers;
+    atomic<bool> m_stop{false};
+    atomic<long> m_queued{0};
+    mutex m_sleepLock;
+    condition_variable m_wake;
+
+    bool popOwn(int self, function<void()> &task) {
+        Worker &w = *m_workers[self];
+        lock_guard<mutex> lock(w.lock);
+        if (w.tasks.empty()) return false;
+        task = move(w.tasks.back());
+        w.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int self, function<void()> &task) {
+        int n = static_cast<int>(m_workers.size());
+        for (int k = 1; k < n; ++k) {
+            Worker &victim = *m_workers[(self + k) % n];
+            lock_guard<mutex> lock(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int self) {
+        t_poolWorker = self;
+        Worker &me = *m_workers[self];
+
+        while (true) {
+            function<void()> task;
+            bool got = popOwn(self, task);
+            if (!got && steal(self, task)) {
+                got = true;
+                me.stolen++;
+            }
+
+            if (got) {
+                m_queued--;
+                task();
+                continue;
+            }
+
+            unique_lock<mutex> lock(m_sleepLock);
+            m_wake.wait(lock, [this] { return m_stop || m_queued > 0; });
+            if (m_stop && m_queued == 0) return;
+        }
+    }
+
+    void push(int worker, function<void()> task) {
+        {
+            Worker &w = *m_workers[worker];
+            lock_guard<mutex> lock(w.lock);
+            w.tasks.push_back(move(task));
+        }
+        {
+            lock_guard<mutex> lock(m_sleepLock);
+            m_queued++;
+        }
+        m_wake.notify_one();
+    }
+
+    // Shared completion state of one parallelFor call
+    struct RangeJob {
+        function<void(size_t, size_t)> body;
+        size_t grain;
+        atomic<size_t> remaining;
+        mutex doneLock;
+        condition_variable done;
+    };
+
+    void runRange(const shared_ptr<RangeJob> &job, size_t begin, size_t end) {
+        while (end - begin > job->grain) {
+            size_t mid = begin + (end - begin) / 2;
+            push(t_poolWorker, [this, job, mid, end] { runRange(job, mid, end); });
+            end = mid;
+        }
+
+        // Account before signalling completion so the caller sees the stats.
+        Worker &me = *m_workers[t_poolWorker];
+        auto start = chrono::steady_clock::now();
+        job->body(begin, end);
+        me.busyNs += chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - start).count();
+        me.executed++;
+
+        if (job->remaining.fetch_sub(end - begin) == end - begin) {
+            lock_guard<mutex> lock(job->doneLock);
+            job->done.notify_all();
+        }
+    }
+
+public:
+    explicit WorkStealingPool(unsigned workerCount) {
+        if (workerCount == 0) workerCount = 1;
+        for (unsigned i = 0; i < workerCount; ++i) {
+            m_workers.push_back(unique_ptr<Worker>(new Worker()));
+        }
+        for (unsigned i = 0; i < workerCount; ++i) {
+            m_workers[i]->runner = thread(&WorkStealingPool::workerLoop, this, static_cast<int>(i));
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            lock_guard<mutex> lock(m_sleepLock);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &w : m_workers) w->runner.join();
+    }
+
+    int size() const { return static_cast<int>(m_workers.size()); }
+
+    // Run body(chunkBegin, chunkEnd) over [begin, end) in chunks of at most
+    // `grain` items and wait until all of them are finished.
+    void parallelFor(size_t begin, size_t end, size_t grain, function<void(size_t, size_t)> body) {
+        if (begin >= end) return;
+
+        auto job = make_shared<RangeJob>();
+        job->body = move(body);
+        job->grain = max<size_t>(grain, 1);
+        job->remaining = end - begin;
+
+        // Seed one slice per worker so all of them start immediately.
+        size_t n = m_workers.size();
+        size_t slice = (end - begin + n - 1) / n;
+        for (size_t w = 0; w < n && begin + w * slice < end; ++w) {
+            size_t b = begin + w * slice;
+            size_t e = min(end, b + slice);
+            push(static_cast<int>(w), [this, job, b, e] { runRange(job, b, e); });
+        }
+
+        unique_lock<mutex> lock(job->doneLock);
+        job->done.wait(lock, [&job] { return job->remaining == 0; });
+    }
+
+    void resetStats() {
+        for (auto &w : m_workers) {
+            w->busyNs = 0;
+            w->executed = 0;
+            w->stolen = 0;
+        }
+    }
+
+    // Per-worker chunks, steals and share of the wall-clock time spent busy
+    void printUtilisation(double wallSeconds) {
+        cout << "Worker  Chunks  Stolen  Busy(ms)  Utilisation\n";
+        for (size_t i = 0; i < m_workers.size(); ++i) {
+            Worker &w = *m_workers[i];
+            double busyMs = w.busyNs / 1e6;
+            double utilisation = wallSeconds > 0 ? 100.0 * busyMs / (wallSeconds * 1000.0) : 0.0;
+            cout << "  " << i << "\t" << w.executed << "\t" << w.stolen << "\t"
+                 << busyMs << "\t  " << min(utilisation, 100.0) << "%\n";
+        }
+    }
+};
+
+// One worker per core, but leave a reader slot for the thread that started
+// the job, so every worker's snapshot can be open at once.
+WorkStealingPool &bulkPool() {
+    static WorkStealingPool pool(min(thread::hardware_concurrency(), unsigned(MAX_READER_SLOTS - 1)));
+    return pool;
+}
+
+const size_t BULK_GRAIN = 1024; // students per task
+
+// --------- Bulk job: average mark per student and for the cohort ---------
+void bulkRecomputeAverages(const StudentArray &students, vector<double> &averages) {
+    averages.assign(students.size(), -1.0); // -1 = no marks yet
+    bulkPool().parallelFor(0, students.size(), BULK_GRAIN, [&](size_t b, size_t e) {
+        ReadSnapshot snap;
+        for (size_t i = b; i < e; ++i) {
+            averageMark(students[i].transcript.read(snap), averages[i]);
+        }
+    });
+}
+
+// --------- Bulk job: render every transcript, in ID order ---------
+void bulkGenerateTranscripts(const StudentArray &students, vector<string> &transcripts) {
+    transcripts.assign(students.size(), string());
+    bulkPool().parallelFor(0, students.size(), BULK_GRAIN, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            ostringstream out;
+            showStudent(students[i], out);
+            transcripts[i] = out.str();
+        }
+    });
+}
+
+// --------- Bulk job: check every record is well formed ---------
+// Returns one message per problem found.
+vector<string> bulkValidateRecords(const StudentArray &students) {
+    mutex problemsLock;
+    vector<string> problems;
+
+    bulkPool().parallelFor(0, students.size(), BULK_GRAIN, [&](size_t b, size_t e) {
+        vector<string> found;
+        ReadSnapshot snap;
+        for (size_t i = b; i < e; ++i) {
+            const Student &s = students[i];
+            if (i > 0 && students[i - 1].id >= s.id) {
+                found.push_back("ID " + to_string(s.id) + " is out of order or duplicated");
+            }
+            if (s.name.empty()) found.push_back("ID " + to_string(s.id) + " has no name");
+            if (s.course.empty()) found.push_back("ID " + to_string(s.id) + " has no course");
+
+            const SubjectList &subjects = s.transcript.read(snap);
+            if (subjects.empty()) found.push_back("ID " + to_string(s.id) + " has no subjects");
+            for (const SubjectRecord &sub : subjects) {
+                if (sub.hasMark && (sub.mark < 0.0 || sub.mark > 100.0)) {
+                    found.push_back("ID " + to_string(s.id) + " has mark " + to_string(sub.mark) +
+                                    " for " + sub.name.str() + " outside 0-100");
+                }
+            }
+        }
+        if (!found.empty()) {
+            lock_guard<mutex> lock(problemsLock);
+            problems.insert(problems.end(), found.begin(), found.end());
+        }
+    });
+    return problems;
+}
+
+// --------- Option 4: Run bulk jobs on all students ---------
+void menuBulkJobs(const StudentArray &students) {
+    if (students.empty()) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Bulk Jobs (" << bulkPool().size() << " worker threads) ---\n";
+        int job = readInt(
+            "1. Recompute average marks\n"
+            "2. Generate all transcripts to a file\n"
+            "3. Re-validate all records\n"
+            "Enter your choice: "
+        );
+        if (job < 1 || job > 3) {
+            cout << "Wrong input, please enter another input (1–3).\n";
+            continue;
+        }
+
+        string fileName;
+        if (job == 2) {
+            cout << "Enter output file name: ";
+            getline(cin, fileName);
+        }
+
+        bulkPool().resetStats();
+        auto start = chrono::steady_clock::now();
+
+        if (job == 1) {
+            vector<double> averages;
+            bulkRecomputeAverages(students, averages);
+            double sum = 0.0;
+            size_t graded = 0;
+            for (double a : averages) {
+                if (a >= 0.0) {
+                    sum += a;
+                    graded++;
+                }
+            }
+            cout << "Students with marks: " << graded << " of " << students.size() << "\n";
+            if (graded > 0) cout << "Cohort average mark: " << sum / graded << "\n";
+        } else if (job == 2) {
+            vector<string> transcripts;
+            bulkGenerateTranscripts(students, transcripts);
+            ofstream out(fileName);
+            for (const string &t : transcripts) out << t;
+            if (out) cout << transcripts.size() << " transcripts written to " << fileName << "\n";
+            else cout << "Could not write " << fileName << "\n";
+        } else {
+            vector<string> problems = bulkValidateRecords(students);
+            cout << problems.size() << " problem(s) found.\n";
+            for (size_t i = 0; i < problems.size() && i < 20; ++i) {
+                cout << "  " << problems[i] << "\n";
+            }
+        }
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "Finished in " << seconds * 1000.0 << " ms\n";
+        bulkPool().printUtilisation(seconds);
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Run another bulk job\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                break;
+            } else if (choice == 2) {
+                return;
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 5: Course rankings ---------
+void menuCourseRankings(const StudentArray &students) {
+    if (students.empty()) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Course Rankings ---\n";
+        cout << "Enter course : ";
+        string course;
+        getline(cin, course);
+
+        int ranked = g_rankings.rankedCount(course);
+        if (ranked == 0) {
+            cout << "No student in " << course << " has marks yet.\n";
+        } else {
+            int k = readInt("How many top students to show: ");
+            vector<pair<int, double>> best = g_rankings.top(course, k > 0 ? k : 0);
+
+            cout << "\nTop " << best.size() << " of " << ranked << " in " << course << ":\n";
+            for (size_t i = 0; i < best.size(); ++i) {
+                int steps = 0;
+                int index = binarySearchById(students, best[i].first, steps);
+                cout << "  " << (i + 1) << ". " << best[i].first << " "
+                     << (index != -1 ? students[index].name.str() : string("?"))
+                     << " - average " << best[i].second << "\n";
+            }
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Show another course\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                break;
+            } else if (choice == 2) {
+                return;
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 6: Lookup cache statistics ---------
+void menuCacheStatistics() {
+    while (true) {
+        cout << "\n--- Lookup Cache ---\n";
+        g_hotCache.printStats(cout);
+
+        int choice = readInt(
+            "\nWhat do you want to do next?\n"
+            "1. Turn the cache on/off\n"
+            "2. Reset counters\n"
+            "3. Return to main menu\n"
+            "Enter your choice: "
+        );
+
+        if (choice == 1) {
+            g_hotCache.setEnabled(!g_hotCache.enabled());
+        } else if (choice == 2) {
+            g_hotCache.resetStats();
+        } else if (choice == 3) {
+            return;
         } else {
-            left = mid + 1;
+            cout << "Wrong input, please enter another input (1–3).\n";
         }
     }
-    return -1; // not found
 }
 
-// --------- Insert student sorted by ID ---------
-void insertStudentSorted(vector<Student> &students, const Student &newStudent) {
-    int idx = binarySearchById(students, newStudent.id, idx);  // Not used, just for demonstration
-    if (idx != -1) {
-        cout << "ID " << newStudent.id << " already exists in the system.\n";
-        return;
-    }
+// --------- Bulk mark updates: sort the batch, then one merge pass ---------
+// A results file can hold hundreds of thousands of marks. Instead of one
+// search per mark, the batch is sorted by ID and walked alongside the sorted
+// student array, each student getting all its marks in one new version.
+struct MarkUpdate {
+    int id;
+    string subject;
+    double mark;
+};
 
-    auto pos = lower_bound(
-        students.begin(),
-        students.end(),
-        newStudent.id,
-        [](const Student &s, int value) {
-            return s.id < value;
+struct BulkUpdateReport {
+    size_t marksApplied = 0;
+    size_t studentsUpdated = 0;
+    vector<int> unmatchedIds;                      // each unknown ID once
+    vector<pair<int, string>> unmatchedSubjects;   // subject not registered for that student
+};
+
+BulkUpdateReport applyMarkUpdates(StudentArray &students, vector<MarkUpdate> updates) {
+    BulkUpdateReport report;
+
+    // Stable, so a later line for the same ID and subject wins.
+    stable_sort(updates.begin(), updates.end(),
+                [](const MarkUpdate &a, const MarkUpdate &b) { return a.id < b.id; });
+
+    size_t pos = 0; // current position in the student array
+    size_t i = 0;
+    while (i < updates.size()) {
+        int id = updates[i].id;
+        size_t groupEnd = i;
+        while (groupEnd < updates.size() && updates[groupEnd].id == id) groupEnd++;
+
+        // Gallop forward to the first student with ID >= id
+        size_t step = 1;
+        size_t hi = pos;
+        while (hi < students.size() && students[hi].id < id) {
+            pos = hi + 1;
+            hi += step;
+            step *= 2;
         }
-    );
+        hi = min(hi, students.size());
+        pos = lower_bound(students.begin() + pos, students.begin() + hi, id,
+                          [](const Student &s, int value) { return s.id < value; }) - students.begin();
 
-    students.insert(pos, newStudent);
-    cout << "Student with ID " << newStudent.id << " has been added successfully.\n";
-}
+        if (pos == students.size() || students[pos].id != id) {
+            report.unmatchedIds.push_back(id);
+            i = groupEnd;
+            continue;
+        }
 
-// --------- Show a single student's info ---------
-void showStudent(const Student &s) {
-    cout << "\n=== Student Information ===\n";
-    cout << "ID     : " << s.id << "\n";
-    cout << "Name   : " << s.name << "\n";
-    cout << "Course : " << s.course << "\n";
-    cout << "Subjects and Marks:\n";
-
-    if (s.subjects.empty()) {
-        cout << "  (No subjects registered)\n";
-    } else {
-        for (size_t i = 0; i < s.subjects.size(); ++i) {
-            cout << "  " << (i + 1) << ". " << s.subjects[i].name << " - ";
-            if (s.subjects[i].hasMark) {
-                cout << s.subjects[i].mark;
-            } else {
-                cout << "(no mark yet)";
+        Student &s = students[pos];
+        SubjectList updated;
+        {
+            ReadSnapshot snap;
+            updated = s.transcript.read(snap);
+        }
+
+        size_t applied = 0;
+        for (; i < groupEnd; ++i) {
+            bool matched = false;
+            for (SubjectRecord &sub : updated) {
+                if (string_view(sub.name) == updates[i].subject) {
+                    sub.mark = updates[i].mark;
+                    sub.hasMark = true;
+                    matched = true;
+                    break;
+                }
             }
-            cout << "\n";
+            if (matched) applied++;
+            else report.unmatchedSubjects.push_back({id, updates[i].subject});
         }
-    }
 
-    cout << "===========================\n";
+        if (applied > 0) {
+            commitMarks(s, move(updated));
+            report.marksApplied += applied;
+            report.studentsUpdated++;
+        }
+    }
+    return report;
 }
 
-// --------- Menu display ---------
-void showMenu() {
-    cout << "\n==============================\n";
-    cout << "  Student ID Search System\n";
-    cout << "  (Sorted Array + Binary Search)\n";
-    cout << "==============================\n";
-    cout << "1. Enter new student\n";
-    cout << "2. Search student by ID\n";
-    cout << "3. Insert marks\n";
-    cout << "4. Exit\n";
-    cout << "Enter your choice: ";
+// Parse one "id,subject,mark" line. Exported results often pad fields or
+// separate them with spaces instead, so whitespace around fields is ignored
+// and a line with no comma is read as "id subject words... mark".
+bool parseMarkUpdate(string line, MarkUpdate &update) {
+    const char *spaces = " \t\r";
+    line.erase(line.find_last_not_of(spaces) + 1); // trailing spaces and CR
+    size_t first = line.find(',');
+    size_t last = line.rfind(',');
+    if (first == string::npos) {
+        first = line.find_first_of(spaces);
+        last = line.find_last_of(spaces);
+    }
+    if (first == string::npos || first == last) return false;
+
+    char *end = nullptr;
+    long id = strtol(line.c_str(), &end, 10);
+    if (end == line.c_str() || line.find_first_not_of(spaces, end - line.c_str()) < first) return false;
+
+    const char *markText = line.c_str() + last + 1;
+    char *markEnd = nullptr;
+    double mark = strtod(markText, &markEnd);
+    if (markEnd == markText || line.find_first_not_of(spaces, markEnd - line.c_str()) != string::npos) return false;
+
+    size_t nameStart = line.find_first_not_of(spaces, first + 1);
+    size_t nameEnd = line.find_last_not_of(spaces, last - 1);
+    if (nameStart == string::npos || nameStart >= last || nameEnd < nameStart) return false;
+
+    update = MarkUpdate{static_cast<int>(id), line.substr(nameStart, nameEnd - nameStart + 1), mark};
+    return true;
 }
 
-// --------- Option 1: Enter new student (with many subjects) ---------
-void menuEnterNewStudent(vector<Student> &students) {
-    while (true) {
-        Student s;
+// Read a results file. Blank lines and lines starting with # are skipped;
+// the numbers of lines that do not parse are returned in badLines.
+bool readMarkUpdates(const string &fileName, vector<MarkUpdate> &updates, vector<size_t> &badLines) {
+    ifstream in(fileName);
+    if (!in) return false;
 
-        cout << "\n--- Enter New Student ---\n";
-        s.id = readInt("Enter student ID (integer): ");
+    badLines.clear();
+    string line;
+    size_t lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        size_t content = line.find_first_not_of(" \t\r");
+        if (content == string::npos || line[content] == '#') continue;
 
-        cout << "Enter name   : ";
-        getline(cin, s.name);
+        MarkUpdate update;
+        if (parseMarkUpdate(line, update)) {
+            updates.push_back(move(update));
+        } else {
+            badLines.push_back(lineNumber);
+        }
+    }
+    return true;
+}
 
-        cout << "Enter course : ";
-        getline(cin, s.course);
+// --------- Option 7: Apply marks from a results file ---------
+void menuBulkMarkUpdate(StudentArray &students) {
+    if (students.empty()) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
 
-        // Enter multiple subjects
-        cout << "\nNow enter subjects for this student.\n";
-        cout << "Press \"Enter\" to add new subject or press \"0\" when you are done.\n";
+    while (true) {
+        cout << "\n--- Apply Marks from Results File ---\n";
+        cout << "Each line: student ID,subject name,mark (or separated by spaces)\n";
+        cout << "Enter file name: ";
+        string fileName;
+        getline(cin, fileName);
 
-        while (true) {
-            SubjectRecord sub;
-            cout << "Enter subject name (or 0 to finish): ";
-            getline(cin, sub.name);
+        vector<MarkUpdate> updates;
+        vector<size_t> badLines;
+        if (!readMarkUpdates(fileName, updates, badLines)) {
+            cout << "Could not open " << fileName << "\n";
+        } else {
+            auto start = chrono::steady_clock::now();
+            BulkUpdateReport report = applyMarkUpdates(students, move(updates));
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-            if (sub.name == "0") {
-                if (s.subjects.empty()) {
-                    cout << "Student must have at least one subject.\n";
-                    continue;
-                } else {
-                    break;
+            cout << report.marksApplied << " marks applied to " << report.studentsUpdated
+                 << " students in " << seconds * 1000.0 << " ms\n";
+            if (!badLines.empty()) {
+                cout << badLines.size() << " line(s) could not be read and were skipped";
+                for (size_t i = 0; i < badLines.size() && i < 10; ++i) {
+                    cout << (i == 0 ? ": line " : ", ") << badLines[i];
                 }
+                cout << (badLines.size() > 10 ? ", ...\n" : "\n");
             }
 
-            sub.hasMark = false;
-            sub.mark = 0.0;
-            s.subjects.push_back(sub);
-        }
+            cout << report.unmatchedIds.size() << " unknown student ID(s)";
+            for (size_t i = 0; i < report.unmatchedIds.size() && i < 10; ++i) {
+                cout << (i == 0 ? ": " : ", ") << report.unmatchedIds[i];
+            }
+            cout << (report.unmatchedIds.size() > 10 ? ", ...\n" : "\n");
 
-        insertStudentSorted(students, s);
+            cout << report.unmatchedSubjects.size() << " mark(s) for subjects the student does not take";
+            for (size_t i = 0; i < report.unmatchedSubjects.size() && i < 10; ++i) {
+                cout << (i == 0 ? ": " : ", ") << report.unmatchedSubjects[i].first
+                     << "/" << report.unmatchedSubjects[i].second;
+            }
+            cout << (report.unmatchedSubjects.size() > 10 ? ", ...\n" : "\n");
+        }
 
         // Ask user what next
         while (true) {
             int choice = readInt(
                 "\nWhat do you want to do next?\n"
-                "1. Enter another student\n"
+                "1. Apply another file\n"
                 "2. Return to main menu\n"
                 "Enter your choice: "
             );
 
             if (choice == 1) {
-                // loop again to add another student
                 break;
             } else if (choice == 2) {
-                return; // back to main menu
+                return;
             } else {
                 cout << "Wrong input, please enter another input (1 or 2).\n";
             }
@@ -191,40 +2854,190 @@ void menuEnterNewStudent(vector<Student> &students) {
     }
 }
 
-// --------- Option 2: Search student by ID ---------
-void menuSearchStudent(const vector<Student> &students) {
+// --------- Memory accounting ---------
+// Where the program's bytes go. Every byte is in exactly one category:
+//   payload  - the data itself: IDs, text characters, marks
+//   index    - bytes that only exist to find or rank students
+//   slack    - reserved but unused: spare capacity, unused inline space,
+//              allocator rounding, old mark versions kept for snapshots
+//   overhead - the rest: size fields, pointers, padding, block headers
+struct MemoryReport {
+    size_t students = 0;
+    size_t total = 0;
+    size_t payload = 0;
+    size_t index = 0;
+    size_t slack = 0;
+    size_t idColumn = 0;   // part of index: the compressed ID column copies
+
+    size_t overhead() const { return total - payload - index - slack; }
+};
+
+template <size_t N>
+void accountText(MemoryReport &report, const InlineString<N> &text) {
+    report.payload += text.size();
+    if (text.onHeap()) {
+        size_t block = heapBlockBytes(text.data());
+        report.total += block;
+        report.slack += N + (block - MALLOC_CHUNK_HEADER - text.size() - 1);
+    } else {
+        report.slack += N - 1 - text.size();
+    }
+}
+
+// Current transcript: the subjects are payload; older versions are slack.
+void accountTranscript(MemoryReport &report, const VersionChain &transcript) {
+    bool current = true;
+    transcript.forEachVersion([&](const MarkVersion &v) {
+        size_t block = heapBlockBytes(&v);
+        size_t spill = v.subjects.onHeap() ? heapBlockBytes(v.subjects.begin()) : 0;
+        report.total += block + spill;
+        if (!current) {
+            size_t names = 0;
+            for (const SubjectRecord &sub : v.subjects) {
+                if (sub.name.onHeap()) names += heapBlockBytes(sub.name.data());
+            }
+            report.total += names;
+            report.slack += block + spill + names;
+            return;
+        }
+        current = false;
+
+        report.slack += block - MALLOC_CHUNK_HEADER - sizeof(MarkVersion);
+        if (v.subjects.onHeap()) {
+            report.slack += SubjectList::INLINE_CAPACITY * sizeof(SubjectRecord); // unused inline slots
+            report.slack += spill - MALLOC_CHUNK_HEADER - v.subjects.size() * sizeof(SubjectRecord);
+        } else {
+            report.slack += (v.subjects.capacity() - v.subjects.size()) * sizeof(SubjectRecord);
+        }
+        for (const SubjectRecord &sub : v.subjects) {
+            report.payload += sizeof(sub.mark) + sizeof(sub.hasMark);
+            accountText(report, sub.name);
+        }
+    });
+}
+
+MemoryReport memoryReport(const StudentArray &students) {
+    MemoryReport report;
+    report.students = students.size();
+
+    // The array buffer: a big mapping rounded to huge pages, or a malloc block
+    size_t bytes = students.capacity() * sizeof(Student);
+    if (bytes >= BIG_ARRAY_THRESHOLD) {
+        report.total += (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        report.slack += report.total - students.size() * sizeof(Student);
+    } else if (students.capacity() > 0) {
+        report.total += heapBlockBytes(students.data());
+        report.slack += report.total - MALLOC_CHUNK_HEADER - students.size() * sizeof(Student);
+    }
+
+    for (const Student &s : students) {
+        report.payload += sizeof(s.id);
+        accountText(report, s.name);
+        accountText(report, s.course);
+        accountTranscript(report, s.transcript);
+    }
+
+    for (const CompressedIdColumn &column : g_idColumns) report.idColumn += column.bytes();
+    size_t index = g_hotCache.bytes() + g_rankings.bytes() + g_cohorts.bytes() + report.idColumn;
+    report.total += index;
+    report.index += index;
+    return report;
+}
+
+void printMemoryReport(const MemoryReport &report, ostream &out) {
+    auto line = [&](const char *label, size_t bytes) {
+        out << label << bytes << " bytes";
+        if (report.total > 0) out << " (" << 100.0 * bytes / report.total << "%)";
+        out << "\n";
+    };
+    out << "Students      : " << report.students << "\n";
+    out << "Total         : " << report.total << " bytes";
+    if (report.students > 0) out << ", " << static_cast<double>(report.total) / report.students << " per student";
+    out << "\n";
+    line("  Payload     : ", report.payload);
+    line("  Index       : ", report.index);
+    out << "    ID column : " << report.idColumn << " bytes";
+    if (report.students > 0) {
+        out << ", " << static_cast<double>(report.idColumn) / report.students
+            << " per student on top of the ID in each record";
+    }
+    out << "\n";
+    line("  Overhead    : ", report.overhead());
+    line("  Slack       : ", report.slack);
+
+    size_t hugetlb, advised, plain;
+    bigArrayUsage(hugetlb, advised, plain);
+    out << "Heap (tracked): " << g_heapBytes.load() << " bytes in " << g_heapBlocks.load() << " blocks\n";
+    out << "Big arrays    : " << hugetlb + advised + plain << " bytes mapped\n";
+}
+
+// --------- Option 8: Memory usage report ---------
+void menuMemoryReport(const StudentArray &students) {
+    cout << "\n--- Memory Usage ---\n";
+    if (g_idColumnStale && !students.empty()) {
+        rebuildIdColumns(students); // report the index a lookup would use
+        g_idColumnStale = false;
+    }
+    printMemoryReport(memoryReport(students), cout);
+}
+
+// --------- Option 9: Cohort query ---------
+// Comma-separated list; blanks around names are dropped.
+vector<string> readNameList(const string &prompt) {
+    cout << prompt;
+    string line;
+    getline(cin, line);
+    vector<string> names;
+    for (string &name : splitFields(line, ',')) {
+        size_t first = name.find_first_not_of(' ');
+        if (first == string::npos) continue;
+        names.push_back(name.substr(first, name.find_last_not_of(' ') - first + 1));
+    }
+    return names;
+}
+
+void menuCohortQuery(const StudentArray &students) {
     if (students.empty()) {
         cout << "\nNo students in the system yet. Please add some first.\n";
         return;
     }
 
     while (true) {
-        cout << "\n--- Search Student by ID ---\n";
-        int targetId = readInt("Enter student ID to search: ");
-        int steps = 0; // Initialize steps counter
+        cout << "\n--- Cohort Query ---\n";
+        cout << "Leave a line empty to skip it. Separate several subjects with commas.\n";
+        CohortQuery query;
+        cout << "Course                             : ";
+        getline(cin, query.course);
+        query.takes = readNameList("Takes all of these subjects       : ");
+        query.marked = readNameList("Has a mark in all of these         : ");
+        query.unmarked = readNameList("Has no mark yet in these           : ");
+        query.anyOf = readNameList("Takes at least one of these        : ");
 
-        int index = binarySearchById(students, targetId, steps);
-        if (index != -1) {
-            showStudent(students[index]);
-            cout << "Steps taken to find the student: " << steps << "\n";
-        } else {
-            cout << "ID " << targetId << " not found in the system.\n";
+        auto start = chrono::steady_clock::now();
+        vector<int> ids = g_cohorts.run(query);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << "\n" << ids.size() << " matching students (" << seconds * 1e6 << " microseconds)\n";
+        for (size_t i = 0; i < ids.size() && i < 20; ++i) {
+            int steps = 0;
+            int index = binarySearchById(students, ids[i], steps);
+            cout << "  " << ids[i] << " " << (index != -1 ? students[index].name.str() : string("?")) << "\n";
         }
+        if (ids.size() > 20) cout << "  ... " << ids.size() - 20 << " more\n";
 
         // Ask user what next
         while (true) {
             int choice = readInt(
                 "\nWhat do you want to do next?\n"
-                "1. Search another ID\n"
+                "1. Run another query\n"
                 "2. Return to main menu\n"
                 "Enter your choice: "
             );
 
             if (choice == 1) {
-                // loop again to search another ID
                 break;
             } else if (choice == 2) {
-                return; // back to main menu
+                return;
             } else {
                 cout << "Wrong input, please enter another input (1 or 2).\n";
             }
@@ -232,73 +3045,416 @@ void menuSearchStudent(const vector<Student> &students) {
     }
 }
 
-// --------- Option 3: Insert marks for subjects ---------
-void menuInsertMarks(vector<Student> &students) {
-    if (students.empty()) {
-        cout << "\nNo students in the system yet. Please add some first.\n";
-        return;
+// --------- Option 10: Operation latency report ---------
+void menuLatencyReport() {
+    while (true) {
+        cout << "\n--- Operation Latency ---\n";
+        g_flightRecorder.printReport(cout);
+
+        int choice = readInt(
+            "\nWhat do you want to do next?\n"
+            "1. Write the slowest operations as a Chrome trace file\n"
+            "2. Reset\n"
+            "3. Return to main menu\n"
+            "Enter your choice: "
+        );
+
+        if (choice == 1) {
+            string fileName;
+            cout << "Enter output file name: ";
+            getline(cin, fileName);
+            ofstream out(fileName);
+            g_flightRecorder.writeChromeTrace(out);
+            if (out) cout << "Trace written to " << fileName << " (open it in chrome://tracing or ui.perfetto.dev)\n";
+            else cout << "Could not write " << fileName << "\n";
+        } else if (choice == 2) {
+            g_flightRecorder.reset();
+        } else if (choice == 3) {
+            return;
+        } else {
+            cout << "Wrong input, please enter another input (1–3).\n";
+        }
     }
+}
 
-    while (true) {
-        cout << "\n--- Insert Marks ---\n";
-        int targetId = readInt("Enter student ID to insert marks: ");
+// ===================================================================
+// Server mode: answer find / add / set-marks over a local socket
+// ===================================================================
+//
+// Start with   ./a.out --serve unix:/tmp/students.sock
+//         or   ./a.out --serve tcp:7000        (binds 127.0.0.1 only)
+//
+// Line protocol, one request per line, one reply line per request, in order:
+//   FIND <id>                         -> OK <id>|<name>|<course>|<subject>=<mark or ->;...
+//   ADD <id>|<name>|<course>|<s1>;<s2>  -> OK | EXISTS
+//   SETMARKS <id> <m1> <m2> ...       -> OK <version>
+//   STATS                             -> OK hits=<n> misses=<n> students=<n>
+//                                          <op>_p50_ns=<n> <op>_p99_ns=<n> <op>_max_ns=<n> ...
+//   TRACE <file>                      -> OK   (slowest operations as a Chrome trace, written by the server)
+//   anything that fails               -> NOTFOUND | ERR <reason>
+// Clients may pipeline: every complete line in one read is answered, and
+// the replies for that read go back in a single write.
 
-        int index = binarySearchById(students, targetId, index); // Not used, just for demo
-        if (index == -1) {
-            cout << "ID " << targetId << " not found in the system.\n";
+const int SERVER_READ_CHUNK = 64 * 1024;
+const int SERVER_MAX_EVENTS = 256;
+const size_t SERVER_MAX_BUFFERED = 4 * 1024 * 1024; // per connection, for each direction
+
+struct ClientConnection {
+    int fd;
+    string in;        // bytes received but not yet parsed
+    string out;       // replies not yet written
+    size_t outSent = 0;
+};
+
+// A client that sends faster than it reads its replies is not read from
+// until its pending replies drain, so the kernel's socket buffers push
+// back on it instead of the server's memory growing without bound.
+bool acceptingInput(const ClientConnection &c) {
+    return c.out.size() - c.outSent < SERVER_MAX_BUFFERED && c.in.size() < SERVER_MAX_BUFFERED;
+}
+
+void appendTranscript(string &out, const Student &s) {
+    ReadSnapshot snap;
+    const SubjectList &subjects = s.transcript.read(snap);
+
+    out += "OK ";
+    out += to_string(s.id);
+    out += '|';
+    out += s.name;
+    out += '|';
+    out += s.course;
+    out += '|';
+    for (size_t i = 0; i < subjects.size(); ++i) {
+        if (i > 0) out += ';';
+        out += subjects[i].name;
+        out += '=';
+        if (subjects[i].hasMark) {
+            ostringstream mark;
+            mark << subjects[i].mark;
+            out += mark.str();
         } else {
-            Student &s = students[index];
-            if (s.subjects.empty()) {
-                cout << "This student has no subjects registered.\n";
-            } else {
-                cout << "\nInserting marks for student:\n";
-                showStudent(s);
-                cout << "\nEnter marks for each subject.\n";
-                cout << "(If you do not want to change a subject's mark, you can enter the same value again.)\n";
+            out += '-';
+        }
+    }
+    out += '\n';
+}
 
-                for (size_t i = 0; i < s.subjects.size(); ++i) {
-                    cout << "\nSubject " << (i + 1) << ": " << s.subjects[i].name << "\n";
-                    double mark = readDouble("Enter mark: ");
-                    s.subjects[i].mark = mark;
-                    s.subjects[i].hasMark = true;
-                }
+// Execute one request line and append its reply.
+void handleRequest(StudentArray &students, const string &line, string &out) {
+    size_t space = line.find(' ');
+    string command = line.substr(0, space);
+    string args = (space == string::npos) ? "" : line.substr(space + 1);
+    int steps = 0;
 
-                cout << "\nAll marks updated for this student.\n";
-                showStudent(s);
-            }
+    if (command == "FIND") {
+        char *end = nullptr;
+        long id = strtol(args.c_str(), &end, 10);
+        if (args.empty() || *end != '\0') {
+            out += "ERR bad id\n";
+            return;
+        }
+        int index = findStudentIndex(students, static_cast<int>(id), steps);
+        if (index == -1) out += "NOTFOUND\n";
+        else appendTranscript(out, students[index]);
+    } else if (command == "ADD") {
+        vector<string> fields = splitFields(args, '|');
+        if (fields.size() != 4 || fields[3].empty()) {
+            out += "ERR expected id|name|course|subjects\n";
+            return;
+        }
+        char *end = nullptr;
+        long id = strtol(fields[0].c_str(), &end, 10);
+        if (fields[0].empty() || *end != '\0') {
+            out += "ERR bad id\n";
+            return;
         }
 
-        // Ask user what next
-        while (true) {
-            int choice = readInt(
-                "\nWhat do you want to do next?\n"
-                "1. Insert marks for another ID\n"
-                "2. Return to main menu\n"
-                "Enter your choice: "
-            );
+        SubjectList subjects;
+        for (const string &name : splitFields(fields[3], ';')) {
+            subjects.push_back(SubjectRecord{name, 0.0, false});
+        }
 
-            if (choice == 1) {
-                // loop again
-                break;
-            } else if (choice == 2) {
+        Student s;
+        s.id = static_cast<int>(id);
+        s.name = fields[1];
+        s.course = fields[2];
+        s.transcript = VersionChain(move(subjects));
+        out += addStudentSorted(students, move(s)) ? "OK\n" : "EXISTS\n";
+    } else if (command == "SETMARKS") {
+        istringstream in(args);
+        int id;
+        if (!(in >> id)) {
+            out += "ERR bad id\n";
+            return;
+        }
+        int index = findStudentIndex(students, id, steps);
+        if (index == -1) {
+            out += "NOTFOUND\n";
+            return;
+        }
+
+        Student &s = students[index];
+        SubjectList updated;
+        {
+            ReadSnapshot snap;
+            updated = s.transcript.read(snap);
+        }
+        for (SubjectRecord &sub : updated) {
+            if (!(in >> sub.mark)) {
+                out += "ERR expected " + to_string(updated.size()) + " marks\n";
                 return;
-            } else {
-                cout << "Wrong input, please enter another input (1 or 2).\n";
             }
+            sub.hasMark = true;
+        }
+        out += "OK " + to_string(commitMarks(s, move(updated))) + "\n";
+    } else if (command == "STATS") {
+        out += "OK hits=" + to_string(g_hotCache.hits()) + " misses=" + to_string(g_hotCache.misses()) +
+               " students=" + to_string(students.size());
+        for (int i = 0; i < OPERATION_COUNT; ++i) {
+            Operation op = static_cast<Operation>(i);
+            LatencySummary s = g_flightRecorder.summary(op);
+            string name = (op == Operation::SetMarks) ? "setmarks" : operationName(op);
+            out += " " + name + "_p50_ns=" + to_string(s.percentile(0.50)) + " " + name + "_p99_ns=" +
+                   to_string(s.percentile(0.99)) + " " + name + "_max_ns=" + to_string(s.maxNs);
+        }
+        out += "\n";
+    } else if (command == "TRACE") {
+        if (args.empty()) {
+            out += "ERR expected file name\n";
+            return;
+        }
+        ofstream file(args);
+        g_flightRecorder.writeChromeTrace(file);
+        out += file ? "OK\n" : "ERR cannot write " + args + "\n";
+    } else {
+        out += "ERR unknown command\n";
+    }
+}
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+// Create the listening socket for "unix:<path>" or "tcp:<port>"; -1 on error.
+int openListener(const string &address) {
+    int fd = -1;
+
+    if (address.rfind("unix:", 0) == 0) {
+        string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            cout << "Socket path is empty or too long.\n";
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, path.c_str());
+        unlink(path.c_str()); // remove a stale socket from an earlier run
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1 || bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1) {
+            cout << "Cannot bind " << path << ": " << strerror(errno) << "\n";
+            if (fd != -1) close(fd);
+            return -1;
+        }
+    } else if (address.rfind("tcp:", 0) == 0) {
+        int port = atoi(address.c_str() + 4);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int yes = 1;
+        if (fd != -1) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (fd == -1 || port <= 0 || bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1) {
+            cout << "Cannot bind 127.0.0.1:" << port << ": " << strerror(errno) << "\n";
+            if (fd != -1) close(fd);
+            return -1;
+        }
+    } else {
+        cout << "Address must be unix:<path> or tcp:<port>.\n";
+        return -1;
+    }
+
+    if (listen(fd, SOMAXCONN) == -1 || !setNonBlocking(fd)) {
+        cout << "Cannot listen: " << strerror(errno) << "\n";
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Write as much pending output as the socket takes. False if the peer is gone.
+bool flushClient(ClientConnection &c) {
+    while (c.outSent < c.out.size()) {
+        ssize_t n = send(c.fd, c.out.data() + c.outSent, c.out.size() - c.outSent, MSG_NOSIGNAL);
+        if (n > 0) {
+            c.outSent += static_cast<size_t>(n);
+        } else if (n == -1 && errno == EINTR) {
+            continue;
+        } else {
+            return n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    c.out.clear();
+    c.outSent = 0;
+    return true;
+}
+
+// Read what is available (up to the buffer limit), answer complete lines
+// while the reply buffer has room, and write. False if the client is gone
+// or sent a line longer than the limit.
+bool serviceClient(StudentArray &students, ClientConnection &c) {
+    char buffer[SERVER_READ_CHUNK];
+    bool peerClosed = false;
+    while (acceptingInput(c)) {
+        ssize_t n = recv(c.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            c.in.append(buffer, static_cast<size_t>(n));
+        } else if (n == 0) {
+            peerClosed = true; // still answer what it sent before closing
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    size_t start = 0;
+    while (true) {
+        while (c.out.size() - c.outSent < SERVER_MAX_BUFFERED) {
+            size_t end = c.in.find('\n', start);
+            if (end == string::npos) break;
+            size_t len = end - start;
+            if (len > 0 && c.in[end - 1] == '\r') len--;
+            handleRequest(students, c.in.substr(start, len), c.out);
+            start = end + 1;
+        }
+        if (!flushClient(c)) return false;
+        // Stop when the socket is full or no complete line is left
+        if (c.out.size() - c.outSent >= SERVER_MAX_BUFFERED || c.in.find('\n', start) == string::npos) break;
+    }
+    c.in.erase(0, start);
+
+    if (c.in.size() >= SERVER_MAX_BUFFERED && c.in.find('\n') == string::npos) {
+        return false; // one request line larger than the whole buffer
+    }
+    return !peerClosed;
+}
+
+// Single-threaded epoll loop; runs until the process is stopped.
+int runServer(StudentArray &students, const string &address) {
+    int listener = openListener(address);
+    if (listener == -1) return 1;
+
+    int epfd = epoll_create1(0);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listener;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, listener, &ev);
+
+    unordered_map<int, ClientConnection> clients;
+    epoll_event events[SERVER_MAX_EVENTS];
+    cout << "Serving student records on " << address << "\n";
+    cout << "NUMA nodes: " << numaNodeCount() << ", huge pages for big arrays: "
+         << (g_bigMemory.hugePages ? "on" : "off") << "\n";
+
+    while (true) {
+        int ready = epoll_wait(epfd, events, SERVER_MAX_EVENTS, -1);
+        if (ready == -1) {
+            if (errno == EINTR) continue;
+            cout << "epoll_wait failed: " << strerror(errno) << "\n";
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+
+            if (fd == listener) {
+                while (true) {
+                    int client = accept(listener, nullptr, nullptr);
+                    if (client == -1) break;
+                    setNonBlocking(client);
+                    int yes = 1;
+                    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)); // fails harmlessly on unix sockets
+                    epoll_event cev{};
+                    cev.events = EPOLLIN | EPOLLRDHUP;
+                    cev.data.fd = client;
+                    epoll_ctl(epfd, EPOLL_CTL_ADD, client, &cev);
+                    clients[client] = ClientConnection{client, "", "", 0};
+                }
+                continue;
+            }
+
+            ClientConnection &c = clients[fd];
+            bool alive = true;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                alive = serviceClient(students, c);
+            } else if (events[i].events & EPOLLOUT) {
+                alive = serviceClient(students, c); // may also answer lines held back while the replies were full
+            }
+
+            if (!alive) {
+                epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+                close(fd);
+                clients.erase(fd);
+                continue;
+            }
+
+            // Only ask for EPOLLOUT while a reply is still waiting to be sent,
+            // and for input only while there is room to buffer it.
+            epoll_event cev{};
+            cev.events = (c.out.empty() ? 0u : static_cast<uint32_t>(EPOLLOUT)) |
+                         (acceptingInput(c) ? static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP) : 0u);
+            cev.data.fd = fd;
+            epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &cev);
         }
     }
+
+    close(epfd);
+    close(listener);
+    return 1;
 }
 
 // --------- main ---------
-int main() {
-    vector<Student> students;
+int main(int argc, char *argv[]) {
+    StudentArray students;
     int choice;
 
+    // Options: --no-cache (benchmark without the hot-ID cache),
+    //          --no-hugepages (plain 4 KB pages for the big arrays),
+    //          --numa=local|interleave|bind:<node> (where big arrays live),
+    //          --serve <address> (run as a server instead of the menu)
+    string serveAddress;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--no-cache") {
+            g_hotCache.setEnabled(false);
+        } else if (arg == "--no-hugepages") {
+            g_bigMemory.hugePages = false;
+        } else if (arg.rfind("--numa=", 0) == 0 && parseNumaOption(arg.substr(7))) {
+            continue;
+        } else if (arg == "--serve" && i + 1 < argc) {
+            serveAddress = argv[++i];
+        } else {
+            cout << "Usage: " << argv[0] << " [--no-cache] [--no-hugepages]"
+                 << " [--numa=local|interleave|bind:<node>] [--serve unix:<path>|tcp:<port>]\n";
+            return 1;
+        }
+    }
+    if (!serveAddress.empty()) {
+        return runServer(students, serveAddress);
+    }
+
     while (true) {
         showMenu();
 
         if (!(cin >> choice)) {
-            cout << "Wrong input, please enter another input (1–4).\n";
+            cout << "Wrong input, please enter another input (1–11).\n";
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             continue;
@@ -316,10 +3472,31 @@ int main() {
                 menuInsertMarks(students);
                 break;
             case 4:
+                menuBulkJobs(students);
+                break;
+            case 5:
+                menuCourseRankings(students);
+                break;
+            case 6:
+                menuCacheStatistics();
+                break;
+            case 7:
+                menuBulkMarkUpdate(students);
+                break;
+            case 8:
+                menuMemoryReport(students);
+                break;
+            case 9:
+                menuCohortQuery(students);
+                break;
+            case 10:
+                menuLatencyReport();
+                break;
+            case 11:
                 cout << "\nExiting program. Goodbye!\n";
                 return 0;
             default:
-                cout << "Wrong input, please enter another input (1–4).\n";
+                cout << "Wrong input, please enter another input (1–11).\n";
                 break;
         }
     }
@@ -2,32 +2,751 @@
 #include <vector>
 #include <limits>
 #include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <new>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <memory>
+#include <malloc.h>
 
 using namespace std;
 
+// --------- Heap tracking ---------
+// Every operator new/delete is counted at the size the allocator really
+// hands out, so the memory report can be checked against the heap itself.
+const size_t MALLOC_CHUNK_HEADER = sizeof(size_t); // glibc keeps the block size in front
+
+atomic<long long> g_heapBytes(0);
+atomic<long long> g_heapBlocks(0);
+
+// Bytes a malloc'd block really occupies (usable size plus the header)
+size_t heapBlockBytes(const void *p) {
+    return malloc_usable_size(const_cast<void *>(p)) + MALLOC_CHUNK_HEADER;
+}
+
+void *operator new(size_t size) {
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw bad_alloc();
+    g_heapBytes.fetch_add(static_cast<long long>(heapBlockBytes(p)), memory_order_relaxed);
+    g_heapBlocks.fetch_add(1, memory_order_relaxed);
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    if (p == nullptr) return;
+    g_heapBytes.fetch_sub(static_cast<long long>(heapBlockBytes(p)), memory_order_relaxed);
+    g_heapBlocks.fetch_sub(1, memory_order_relaxed);
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    operator delete(p);
+}
+
+// --------- Inline string: short text stored inside the record ---------
+// Up to N - 1 characters live in the object itself; only longer text goes
+// to the heap. Names, courses and subject names are almost always short, so
+// building a student normally allocates nothing for them.
+template <size_t N>
+class InlineString {
+private:
+    uint32_t m_size = 0;
+    char *m_heap = nullptr;   // only for text that does not fit inline
+    char m_inline[N] = {};
+
+    void assign(const char *text, size_t length) {
+        char *target = m_inline;
+        if (length >= N) {
+            target = new char[length + 1];
+        }
+        memcpy(target, text, length);
+        target[length] = '\0';
+        delete[] m_heap;
+        m_heap = (target == m_inline) ? nullptr : target;
+        m_size = static_cast<uint32_t>(length);
+    }
+
+public:
+    InlineString() = default;
+    InlineString(const char *text) { assign(text, strlen(text)); }
+    InlineString(const string &text) { assign(text.data(), text.size()); }
+
+    InlineString(const InlineString &other) { assign(other.data(), other.size()); }
+
+    InlineString(InlineString &&other) noexcept : m_size(other.m_size), m_heap(other.m_heap) {
+        memcpy(m_inline, other.m_inline, N);
+        other.m_heap = nullptr;
+        other.m_size = 0;
+        other.m_inline[0] = '\0';
+    }
+
+    InlineString &operator=(const InlineString &other) {
+        if (this != &other) assign(other.data(), other.size());
+        return *this;
+    }
+
+    InlineString &operator=(InlineString &&other) noexcept {
+        if (this != &other) {
+            delete[] m_heap;
+            m_size = other.m_size;
+            m_heap = other.m_heap;
+            memcpy(m_inline, other.m_inline, N);
+            other.m_heap = nullptr;
+            other.m_size = 0;
+            other.m_inline[0] = '\0';
+        }
+        return *this;
+    }
+
+    InlineString &operator=(const string &text) {
+        assign(text.data(), text.size());
+        return *this;
+    }
+
+    InlineString &operator=(const char *text) {
+        assign(text, strlen(text));
+        return *this;
+    }
+
+    ~InlineString() {
+        delete[] m_heap;
+    }
+
+    const char *data() const { return m_heap != nullptr ? m_heap : m_inline; }
+    const char *c_str() const { return data(); }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool onHeap() const { return m_heap != nullptr; }
+    string str() const { return string(data(), m_size); }
+    operator string_view() const { return string_view(data(), m_size); }
+
+    bool operator==(const char *text) const { return string_view(*this) == text; }
+};
+
+template <size_t N>
+ostream &operator<<(ostream &out, const InlineString<N> &text) {
+    return out.write(text.data(), static_cast<streamsize>(text.size()));
+}
+
+// --------- Small vector: the first N elements stored inside the object ---------
+template <typename T, size_t N>
+class SmallVector {
+public:
+    static const size_t INLINE_CAPACITY = N;
+
+private:
+    T *m_data;
+    size_t m_size = 0;
+    size_t m_capacity = N;
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+    T *inlineData() { return reinterpret_cast<T *>(m_inline); }
+    bool isInline() const { return m_data == reinterpret_cast<const T *>(m_inline); }
+
+    void grow() {
+        size_t capacity = m_capacity * 2;
+        T *bigger = static_cast<T *>(::operator new(capacity * sizeof(T)));
+        for (size_t i = 0; i < m_size; ++i) {
+            new (bigger + i) T(move(m_data[i]));
+            m_data[i].~T();
+        }
+        if (!isInline()) ::operator delete(m_data);
+        m_data = bigger;
+        m_capacity = capacity;
+    }
+
+    // Take other's elements; other is left empty.
+    void steal(SmallVector &other) {
+        if (other.isInline()) {
+            m_data = inlineData();
+            m_capacity = N;
+            for (size_t i = 0; i < other.m_size; ++i) {
+                new (m_data + i) T(move(other.m_data[i]));
+                other.m_data[i].~T();
+            }
+        } else {
+            m_data = other.m_data;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inlineData();
+            other.m_capacity = N;
+        }
+        m_size = other.m_size;
+        other.m_size = 0;
+    }
+
+public:
+    SmallVector() : m_data(inlineData()) {}
+
+    SmallVector(const SmallVector &other) : m_data(inlineData()) {
+        for (const T &item : other) push_back(item);
+    }
+
+    SmallVector(SmallVector &&other) noexcept : m_data(inlineData()) {
+        steal(other);
+    }
+
+    SmallVector &operator=(const SmallVector &other) {
+        if (this != &other) {
+            clear();
+            for (const T &item : other) push_back(item);
+        }
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other) noexcept {
+        if (this != &other) {
+            clear();
+            if (!isInline()) ::operator delete(m_data);
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        clear();
+        if (!isInline()) ::operator delete(m_data);
+    }
+
+    void push_back(const T &item) {
+        if (m_size == m_capacity) grow();
+        new (m_data + m_size) T(item);
+        m_size++;
+    }
+
+    void push_back(T &&item) {
+        if (m_size == m_capacity) grow();
+        new (m_data + m_size) T(move(item));
+        m_size++;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < m_size; ++i) m_data[i].~T();
+        m_size = 0;
+    }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    bool onHeap() const { return !isInline(); }
+    T &operator[](size_t i) { return m_data[i]; }
+    const T &operator[](size_t i) const { return m_data[i]; }
+    T *begin() { return m_data; }
+    T *end() { return m_data + m_size; }
+    const T *begin() const { return m_data; }
+    const T *end() const { return m_data + m_size; }
+};
+
 // --------- Subject and Student structures ---------
+// A float keeps about seven significant digits, plenty for a mark out of
+// 100, and keeps the record at 48 bytes instead of 56.
 struct SubjectRecord {
-    string name;
-    double mark;
+    InlineString<24> name;
+    float mark;
     bool hasMark;
 };
 
+// Subjects of one student; up to 4 are kept inline. Most students take
+// three or four, and every inline slot is paid for by every student.
+using SubjectList = SmallVector<SubjectRecord, 4>;
+
+// A student with short name, course and up to 4 subjects needs no heap
+// allocation of its own; the tree node is its only allocation.
 struct Student {
     int id;
-    string name;
-    string course;
-    vector<SubjectRecord> subjects;
+    InlineString<40> name;
+    InlineString<32> course;
+    SubjectList subjects;
+};
+
+// --------- Epoch-based reclamation ---------
+// A marks update replaces a student's subject list while other threads may
+// still be reading the old one. Readers announce the global epoch they
+// entered in; a replaced list is freed only once the epoch has moved two
+// steps past the one it was retired in, when no reader can still hold it.
+const int MAX_EPOCH_THREADS = 64;
+
+struct alignas(64) EpochSlot {
+    atomic<uint64_t> active{0}; // epoch of the reader in this slot, 0 = idle
+    atomic<bool> taken{false};
+};
+
+atomic<uint64_t> g_epoch(1);
+EpochSlot g_epochSlots[MAX_EPOCH_THREADS];
+
+struct EpochThreadState {
+    int slot = -1;     // slot held by the open guard, -1 = none
+    int lastSlot = 0;  // tried first next time; usually still free
+    int depth = 0;     // nested guards on one thread share the outer one
+};
+
+thread_local EpochThreadState t_epoch;
+
+// Take a free epoch slot. A slot is held only while a guard is open, so
+// more than MAX_EPOCH_THREADS threads can read; the extra ones wait for a
+// guard to close.
+int acquireEpochSlot() {
+    const int WARN_AFTER = 100000; // yields before reporting the wait
+    for (int attempt = 0;; ++attempt) {
+        for (int k = 0; k < MAX_EPOCH_THREADS; ++k) {
+            int i = (t_epoch.lastSlot + k) % MAX_EPOCH_THREADS;
+            bool expected = false;
+            if (g_epochSlots[i].taken.compare_exchange_strong(expected, true)) {
+                t_epoch.lastSlot = i;
+                return i;
+            }
+        }
+        if (attempt == WARN_AFTER) {
+            cerr << "Warning: all " << MAX_EPOCH_THREADS << " epoch slots are held by open guards; waiting.\n";
+        }
+        this_thread::yield(); // all slots busy
+    }
+}
+
+// Everything read from the tree inside a guard stays valid until it ends.
+class EpochGuard {
+public:
+    EpochGuard() {
+        if (t_epoch.depth++ > 0) return;
+        t_epoch.slot = acquireEpochSlot();
+
+        // Re-check after announcing, so the epoch cannot move past us unseen
+        atomic<uint64_t> &active = g_epochSlots[t_epoch.slot].active;
+        uint64_t epoch;
+        do {
+            epoch = g_epoch.load();
+            active.store(epoch);
+        } while (epoch != g_epoch.load());
+    }
+
+    ~EpochGuard() {
+        if (--t_epoch.depth == 0) {
+            EpochSlot &slot = g_epochSlots[t_epoch.slot];
+            slot.active.store(0);
+            slot.taken.store(false);
+            t_epoch.slot = -1;
+        }
+    }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+};
+
+mutex g_retiredLock; // retiring is rare (marks updates); readers never take it
+vector<pair<uint64_t, SubjectList *>> g_retired;
+
+// Hand over a subject list no longer reachable from the tree.
+void retireSubjects(SubjectList *old) {
+    lock_guard<mutex> lock(g_retiredLock);
+    g_retired.push_back({g_epoch.load(), old});
+
+    // Move the epoch on if every active reader has reached it
+    uint64_t epoch = g_epoch.load();
+    bool allCurrent = true;
+    for (int i = 0; i < MAX_EPOCH_THREADS; ++i) {
+        uint64_t active = g_epochSlots[i].active.load();
+        if (active != 0 && active != epoch) allCurrent = false;
+    }
+    if (allCurrent) g_epoch.compare_exchange_strong(epoch, epoch + 1);
+
+    epoch = g_epoch.load();
+    size_t kept = 0;
+    for (auto &entry : g_retired) {
+        if (entry.first + 2 <= epoch) delete entry.second;
+        else g_retired[kept++] = entry;
+    }
+    g_retired.resize(kept);
+}
+
+// --------- Latency flight recorder ---------
+// Every add, find and set-marks is timed, always, so a slow operation can
+// still be looked at after it happened. Each thread records into its own
+// histograms without locking; a report adds them up. The histograms are
+// HDR-style: exact below 64 ns, then 32 buckets per power of two, so every
+// latency is kept to within about 3%. Each thread also keeps its slowest
+// operations with the student ID and step count, for a text report or a
+// Chrome trace file (open in chrome://tracing or ui.perfetto.dev).
+enum class Operation { Add, Find, SetMarks };
+const int OPERATION_COUNT = 3;
+
+const char *operationName(Operation op) {
+    switch (op) {
+        case Operation::Add: return "add";
+        case Operation::Find: return "find";
+        case Operation::SetMarks: return "set-marks";
+    }
+    return "?";
+}
+
+// Counts of one or more histograms, added up for reporting
+struct LatencySummary {
+    vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+
+    double meanNs() const { return count == 0 ? 0.0 : static_cast<double>(totalNs) / count; }
+
+    // Latency that a fraction q of operations did not exceed
+    uint64_t percentile(double q) const;
+};
+
+class LatencyHistogram {
+public:
+    static const int EXACT = 64;        // one bucket per nanosecond below this
+    static const int SUB_BUCKETS = 32;  // per power of two above it
+    static const int MAX_SHIFT = 34;    // up to 2^40 ns (18 minutes); longer goes in the last bucket
+    static const int BUCKETS = EXACT + MAX_SHIFT * SUB_BUCKETS;
+
+    static int bucketFor(uint64_t ns) {
+        if (ns < EXACT) return static_cast<int>(ns);
+        int msb = 63 - __builtin_clzll(ns);
+        int shift = msb - 5; // keep the top 6 bits: 32 sub-buckets
+        if (shift > MAX_SHIFT) return BUCKETS - 1;
+        return EXACT + (shift - 1) * SUB_BUCKETS + static_cast<int>(ns >> shift) - SUB_BUCKETS;
+    }
+
+    // Largest latency that falls in the bucket
+    static uint64_t bucketTop(int bucket) {
+        if (bucket < EXACT) return bucket;
+        int shift = (bucket - EXACT) / SUB_BUCKETS + 1;
+        uint64_t top = (bucket - EXACT) % SUB_BUCKETS + SUB_BUCKETS;
+        return ((top + 1) << shift) - 1;
+    }
+
+    // Owner thread only. With a single writer a plain load and store is
+    // enough; the atomics only let reports read while it records.
+    void record(uint64_t ns) {
+        bump(m_counts[bucketFor(ns)], 1);
+        bump(m_count, 1);
+        bump(m_totalNs, ns);
+        if (ns > m_maxNs.load(memory_order_relaxed)) m_maxNs.store(ns, memory_order_relaxed);
+    }
+
+    // Any thread
+    void addTo(LatencySummary &summary) const {
+        summary.counts.resize(BUCKETS, 0);
+        for (int i = 0; i < BUCKETS; ++i) {
+            summary.counts[i] += m_counts[i].load(memory_order_relaxed);
+        }
+        summary.count += m_count.load(memory_order_relaxed);
+        summary.totalNs += m_totalNs.load(memory_order_relaxed);
+        summary.maxNs = max(summary.maxNs, m_maxNs.load(memory_order_relaxed));
+    }
+
+    // Only while the owner thread is not recording
+    void reset() {
+        for (auto &c : m_counts) c.store(0, memory_order_relaxed);
+        m_count.store(0, memory_order_relaxed);
+        m_totalNs.store(0, memory_order_relaxed);
+        m_maxNs.store(0, memory_order_relaxed);
+    }
+
+private:
+    static void bump(atomic<uint64_t> &counter, uint64_t by) {
+        counter.store(counter.load(memory_order_relaxed) + by, memory_order_relaxed);
+    }
+
+    atomic<uint64_t> m_counts[BUCKETS] = {};
+    atomic<uint64_t> m_count{0};
+    atomic<uint64_t> m_totalNs{0};
+    atomic<uint64_t> m_maxNs{0};
+};
+
+uint64_t LatencySummary::percentile(double q) const {
+    uint64_t rank = max<uint64_t>(static_cast<uint64_t>(q * count + 0.5), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) return min(LatencyHistogram::bucketTop(static_cast<int>(i)), maxNs);
+    }
+    return maxNs;
+}
+
+// One operation slow enough to be kept
+struct SlowOperation {
+    Operation op;
+    int id;
+    int steps;
+    uint64_t startNs;    // since the recorder was last reset
+    uint64_t durationNs;
+    int thread;          // recorder's own thread number
+};
+
+class FlightRecorder {
+public:
+    using Clock = chrono::steady_clock;
+    static const size_t SLOW_CAPACITY = 16; // slowest operations kept per thread
+
+    FlightRecorder() : m_startNs(Clock::now().time_since_epoch().count()) {}
+
+    void record(Operation op, int id, int steps, Clock::time_point start, Clock::time_point end) {
+        uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+        ThreadLog &log = local();
+        log.histograms[static_cast<int>(op)].record(ns);
+        if (ns <= log.slowThreshold.load(memory_order_relaxed)) {
+            return; // the common case: not among this thread's slowest
+        }
+
+        lock_guard<mutex> lock(log.slowLock);
+        long long started = chrono::duration_cast<chrono::nanoseconds>(start.time_since_epoch()).count() -
+                            m_startNs.load(memory_order_relaxed);
+        SlowOperation entry{op, id, steps, static_cast<uint64_t>(max(0LL, started)), ns, log.thread};
+        if (log.slowest.size() < SLOW_CAPACITY) {
+            log.slowest.push_back(entry);
+            if (log.slowest.size() < SLOW_CAPACITY) return;
+        } else {
+            *fastestSlow(log) = entry;
+        }
+        log.slowThreshold.store(fastestSlow(log)->durationNs, memory_order_relaxed);
+    }
+
+    // Forget everything recorded so far. Call only while no thread is
+    // running an operation.
+    void reset() {
+        lock_guard<mutex> lock(m_lock);
+        for (auto &log : m_threads) {
+            for (auto &h : log->histograms) h.reset();
+            lock_guard<mutex> slowLock(log->slowLock);
+            log->slowest.clear();
+            log->slowThreshold.store(0, memory_order_relaxed);
+        }
+        m_startNs.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+    }
+
+    // Histograms of every thread for one operation, merged
+    LatencySummary summary(Operation op) {
+        LatencySummary total;
+        lock_guard<mutex> lock(m_lock);
+        for (auto &log : m_threads) log->histograms[static_cast<int>(op)].addTo(total);
+        return total;
+    }
+
+    // Slowest operations kept by every thread, slowest first
+    vector<SlowOperation> slowest() {
+        vector<SlowOperation> all;
+        lock_guard<mutex> lock(m_lock);
+        for (auto &log : m_threads) {
+            lock_guard<mutex> slowLock(log->slowLock);
+            all.insert(all.end(), log->slowest.begin(), log->slowest.end());
+        }
+        sort(all.begin(), all.end(),
+             [](const SlowOperation &a, const SlowOperation &b) { return a.durationNs > b.durationNs; });
+        return all;
+    }
+
+    // Percentiles per operation, then the top slowest operations
+    void printReport(ostream &out, size_t top = 10) {
+        out << left << setw(10) << "Operation" << right << setw(10) << "Count" << setw(10) << "Mean"
+            << setw(10) << "p50" << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "p99.9"
+            << setw(10) << "Max" << "  (ns)\n";
+        for (int i = 0; i < OPERATION_COUNT; ++i) {
+            Operation op = static_cast<Operation>(i);
+            LatencySummary s = summary(op);
+            out << left << setw(10) << operationName(op) << right << setw(10) << s.count
+                << setw(10) << static_cast<uint64_t>(s.meanNs()) << setw(10) << s.percentile(0.50)
+                << setw(10) << s.percentile(0.90) << setw(10) << s.percentile(0.99)
+                << setw(10) << s.percentile(0.999) << setw(10) << s.maxNs << "\n";
+        }
+
+        vector<SlowOperation> slow = slowest();
+        out << "Slowest operations:\n";
+        for (size_t i = 0; i < slow.size() && i < top; ++i) {
+            const SlowOperation &s = slow[i];
+            out << setw(4) << i + 1 << ". " << left << setw(10) << operationName(s.op) << right
+                << "ID " << setw(9) << s.id << "  steps " << setw(6) << s.steps
+                << "  " << setw(9) << s.durationNs << " ns  (thread " << s.thread << ")\n";
+        }
+    }
+
+    // Every kept slow operation as a complete event on its thread's track
+    void writeChromeTrace(ostream &out) {
+        vector<SlowOperation> slow = slowest();
+        size_t threads;
+        {
+            lock_guard<mutex> lock(m_lock);
+            threads = m_threads.size();
+        }
+
+        out << "{\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]() {
+            out << (first ? "" : ",\n");
+            first = false;
+        };
+        for (size_t t = 0; t < threads; ++t) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+        }
+        out << fixed << setprecision(3);
+        for (const SlowOperation &s : slow) {
+            separator();
+            out << "{\"name\":\"" << operationName(s.op) << "\",\"cat\":\"student-db\",\"ph\":\"X\",\"pid\":1"
+                << ",\"tid\":" << s.thread << ",\"ts\":" << s.startNs / 1000.0 << ",\"dur\":" << s.durationNs / 1000.0
+                << ",\"args\":{\"id\":" << s.id << ",\"steps\":" << s.steps << "}}";
+        }
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+private:
+    struct ThreadLog {
+        int thread = 0;
+        LatencyHistogram histograms[OPERATION_COUNT];
+        atomic<uint64_t> slowThreshold{0}; // fastest kept slow op, once the list is full
+        mutex slowLock;                    // the owner takes it only to keep a slow op
+        vector<SlowOperation> slowest;     // at most SLOW_CAPACITY, unordered
+    };
+
+    mutex m_lock; // guards m_threads
+    vector<unique_ptr<ThreadLog>> m_threads; // outlive their threads, for later reports
+    atomic<long long> m_startNs;
+
+    static SlowOperation *fastestSlow(ThreadLog &log) {
+        return &*min_element(log.slowest.begin(), log.slowest.end(),
+                             [](const SlowOperation &a, const SlowOperation &b) { return a.durationNs < b.durationNs; });
+    }
+
+    // This thread's log, created on its first operation
+    ThreadLog &local() {
+        thread_local ThreadLog *log = nullptr;
+        if (log == nullptr) {
+            lock_guard<mutex> lock(m_lock);
+            m_threads.push_back(make_unique<ThreadLog>());
+            log = m_threads.back().get();
+            log->thread = static_cast<int>(m_threads.size()) - 1;
+        }
+        return *log;
+    }
+};
+
+FlightRecorder g_flightRecorder;
+
+// Times one operation and hands it to the flight recorder when it goes out
+// of scope. steps is read then, so it covers the whole operation.
+class OperationTimer {
+public:
+    OperationTimer(Operation op, int id, const int &steps)
+        : m_op(op), m_id(id), m_steps(steps), m_start(FlightRecorder::Clock::now()) {}
+
+    ~OperationTimer() { g_flightRecorder.record(m_op, m_id, m_steps, m_start, FlightRecorder::Clock::now()); }
+
+    OperationTimer(const OperationTimer &) = delete;
+    OperationTimer &operator=(const OperationTimer &) = delete;
+
+private:
+    Operation m_op;
+    int m_id;
+    const int &m_steps;
+    FlightRecorder::Clock::time_point m_start;
 };
 
 // --------- Binary Search Tree Node ---------
+// Child links are atomic so many threads can insert at once: a new node is
+// linked in with one compare-and-swap on an empty link, and a reader sees
+// either no node or a fully built one. Nodes are never removed, so the
+// links themselves need no reclamation.
 struct TreeNode {
-    Student student;
-    TreeNode* left;
-    TreeNode* right;
+    Student student;                  // never changes once linked, except through `marks`
+    atomic<SubjectList *> marks;      // latest subjects after a marks update, else null
+    atomic<TreeNode*> left;
+    atomic<TreeNode*> right;
+
+    // The student is moved in, never copied
+    TreeNode(Student&& newStudent) : student(move(newStudent)), marks(nullptr), left(nullptr), right(nullptr) {}
+};
+
+// Subjects as of now; call inside an EpochGuard if marks may change concurrently.
+const SubjectList &currentSubjects(const TreeNode* node) {
+    const SubjectList *latest = node->marks.load(memory_order_acquire);
+    return latest != nullptr ? *latest : node->student.subjects;
+}
+
+// Publish a complete new subject list for the student.
+void publishSubjects(TreeNode* node, SubjectList&& subjects) {
+    const int steps = 0; // finding the node was already recorded as a find
+    OperationTimer timer(Operation::SetMarks, node->student.id, steps);
+    SubjectList *old = node->marks.exchange(new SubjectList(move(subjects)), memory_order_acq_rel);
+    if (old != nullptr) retireSubjects(old);
+}
 
-    TreeNode(const Student& newStudent) : student(newStudent), left(nullptr), right(nullptr) {}
+// Visit every node in ID order. Nodes linked during the walk may or may not
+// be visited, but nothing is visited twice or out of order.
+template <typename Visitor>
+void forEachNode(TreeNode* root, Visitor visit) {
+    // Iterative; a degenerate tree would overflow a recursive walk.
+    vector<TreeNode*> stack;
+    TreeNode* current = root;
+    while (current != nullptr || !stack.empty()) {
+        while (current != nullptr) {
+            stack.push_back(current);
+            current = current->left.load(memory_order_acquire);
+        }
+        TreeNode* node = stack.back();
+        stack.pop_back();
+        if (!visit(node)) return;
+        current = node->right.load(memory_order_acquire);
+    }
+}
+
+// --------- Contiguous node storage ---------
+// A bulk build places all of its nodes in one block, in ID order, instead
+// of one heap block per node. Students inserted later still get a node of
+// their own, linked under the arena's nodes.
+struct NodeArena {
+    TreeNode* nodes;
+    size_t count;
 };
 
+vector<NodeArena> g_nodeArenas; // changed only while no other thread uses the tree
+
+bool inNodeArena(const TreeNode* node) {
+    for (const NodeArena &arena : g_nodeArenas) {
+        if (node >= arena.nodes && node < arena.nodes + arena.count) return true;
+    }
+    return false;
+}
+
+// Free every node and subject list of the tree. No other thread may be
+// using it.
+void destroyTree(TreeNode* root) {
+    vector<TreeNode*> nodes;
+    forEachNode(root, [&](TreeNode* node) {
+        nodes.push_back(node);
+        return true;
+    });
+    for (TreeNode* node : nodes) {
+        delete node->marks.load();
+        if (inNodeArena(node)) node->~TreeNode();
+        else delete node;
+    }
+    for (const NodeArena &arena : g_nodeArenas) ::operator delete(arena.nodes);
+    g_nodeArenas.clear();
+}
+
+// Longest path from the root to a leaf, counted in nodes
+size_t treeHeight(TreeNode* root) {
+    size_t height = 0;
+    vector<pair<TreeNode*, size_t>> pending;
+    if (root != nullptr) pending.push_back({root, 1});
+    while (!pending.empty()) {
+        auto [node, depth] = pending.back();
+        pending.pop_back();
+        height = max(height, depth);
+        if (TreeNode* left = node->left.load(memory_order_acquire)) pending.push_back({left, depth + 1});
+        if (TreeNode* right = node->right.load(memory_order_acquire)) pending.push_back({right, depth + 1});
+    }
+    return height;
+}
+
 // --------- Helper: safely read an integer ---------
 int readInt(const string &prompt) {
     int value;
@@ -61,35 +780,140 @@ double readDouble(const string &prompt) {
 }
 
 // --------- Insert a student into the Binary Search Tree ---------
-void insertStudent(TreeNode*& root, const Student& newStudent, int& steps) {
-    steps++;  // Increment step for each comparison
-    
-    if (root == nullptr) {
-        root = new TreeNode(newStudent);
-        cout << "Student with ID " << newStudent.id << " has been added successfully.\n";
-    } else if (newStudent.id < root->student.id) {
-        insertStudent(root->left, newStudent, steps);  // Go left if new ID is smaller
-    } else if (newStudent.id > root->student.id) {
-        insertStudent(root->right, newStudent, steps);  // Go right if new ID is larger
-    } else {
-        cout << "ID " << newStudent.id << " already exists in the system.\n";
+// Lock-free: walk down to an empty link and swing it to the new node. If
+// another thread filled that link first, continue the walk from its node.
+// The node is only built once an empty link is found, so a duplicate ID
+// usually costs no allocation. Returns false if the ID already exists.
+bool insertStudent(atomic<TreeNode*>& root, Student&& newStudent, int& steps) {
+    int id = newStudent.id;
+    OperationTimer timer(Operation::Add, id, steps);
+    unique_ptr<TreeNode> node; // kept across lost races
+    atomic<TreeNode*>* link = &root;
+
+    while (true) {
+        TreeNode* current = link->load(memory_order_acquire);
+        if (current == nullptr) {
+            if (!node) node.reset(new TreeNode(move(newStudent)));
+            if (link->compare_exchange_weak(current, node.get(), memory_order_release, memory_order_acquire)) {
+                node.release();
+                return true;
+            }
+            if (current == nullptr) continue; // spurious failure, try again
+        }
+
+        steps++;  // Increment step for each comparison
+        if (id == current->student.id) {
+            return false;
+        }
+        link = (id < current->student.id) ? &current->left : &current->right;
     }
 }
 
 // --------- Search for a student by ID in the Binary Search Tree ---------
-bool searchStudent(TreeNode* root, int targetId, int& steps) {
-    if (root == nullptr) {
-        return false;
+TreeNode* searchStudent(TreeNode* root, int targetId, int& steps) {
+    OperationTimer timer(Operation::Find, targetId, steps);
+    TreeNode* current = root;
+    while (current != nullptr) {
+        steps++;  // Increment steps on each comparison
+        if (targetId == current->student.id) {
+            return current;
+        }
+        current = (targetId < current->student.id) ? current->left.load(memory_order_acquire)
+                                                   : current->right.load(memory_order_acquire);
     }
+    return nullptr;
+}
 
-    steps++;  // Increment steps on each comparison
-    if (targetId == root->student.id) {
-        return true;
-    } else if (targetId < root->student.id) {
-        return searchStudent(root->left, targetId, steps);  // Search in left subtree
+// --------- Bulk build: parallel sort, then a balanced tree in one arena ---------
+// Inserting n students one by one costs O(n^2) when they arrive in ID
+// order and leaves the tree in whatever shape the arrival order gives.
+// Sorting first lets the tree be built directly: the middle student is
+// the root and each half becomes a subtree, so the height is the minimum
+// possible. Both the sort and the build split their work across threads.
+const ptrdiff_t PARALLEL_CUTOFF = 1 << 16; // smaller ranges are not worth a thread
+
+struct BuildKey {
+    int id;
+    uint32_t index; // position in the input; the first copy of an ID wins
+
+    bool operator<(const BuildKey &other) const {
+        return id != other.id ? id < other.id : index < other.index;
+    }
+};
+
+// Merge sort whose halves run on separate threads until threads run out.
+// scratch has room for last - first keys.
+void parallelSort(BuildKey* first, BuildKey* last, BuildKey* scratch, int threads) {
+    if (threads <= 1 || last - first < PARALLEL_CUTOFF) {
+        sort(first, last);
+        return;
+    }
+    BuildKey* middle = first + (last - first) / 2;
+    thread left(parallelSort, first, middle, scratch, threads / 2);
+    parallelSort(middle, last, scratch + (middle - first), threads - threads / 2);
+    left.join();
+    BuildKey* merged = merge(first, middle, middle, last, scratch);
+    copy(scratch, merged, first);
+}
+
+// Build nodes[lo, hi) from the sorted keys as a balanced subtree and
+// return its root. Each node is constructed by the thread that links it.
+TreeNode* buildBalanced(const vector<BuildKey> &keys, vector<Student> &students, TreeNode* nodes,
+                        size_t lo, size_t hi, int threads) {
+    if (lo >= hi) return nullptr;
+
+    size_t mid = lo + (hi - lo) / 2;
+    TreeNode* root = new (nodes + mid) TreeNode(move(students[keys[mid].index]));
+
+    TreeNode* left;
+    TreeNode* right;
+    if (threads > 1 && static_cast<ptrdiff_t>(hi - lo) >= PARALLEL_CUTOFF) {
+        thread worker([&] { left = buildBalanced(keys, students, nodes, lo, mid, threads / 2); });
+        right = buildBalanced(keys, students, nodes, mid + 1, hi, threads - threads / 2);
+        worker.join();
     } else {
-        return searchStudent(root->right, targetId, steps);  // Search in right subtree
+        left = buildBalanced(keys, students, nodes, lo, mid, 1);
+        right = buildBalanced(keys, students, nodes, mid + 1, hi, 1);
+    }
+    // Relaxed is enough: the caller publishes the whole tree at once
+    root->left.store(left, memory_order_relaxed);
+    root->right.store(right, memory_order_relaxed);
+    return root;
+}
+
+struct BulkBuildReport {
+    size_t students = 0;    // nodes in the new tree
+    size_t duplicates = 0;  // later copies of an ID that were dropped
+    double sortSeconds = 0.0;
+    double buildSeconds = 0.0;
+};
+
+// Build a balanced tree from students in any order, keeping the first copy
+// of each ID. The students are moved out. Publish the result with a
+// release store before other threads use it.
+TreeNode* buildBalancedTree(vector<Student> &students, int threads, BulkBuildReport &report) {
+    auto start = chrono::steady_clock::now();
+    vector<BuildKey> keys(students.size());
+    for (size_t i = 0; i < students.size(); ++i) {
+        keys[i] = {students[i].id, static_cast<uint32_t>(i)};
     }
+    vector<BuildKey> scratch(keys.size());
+    parallelSort(keys.data(), keys.data() + keys.size(), scratch.data(), threads);
+    auto last = unique(keys.begin(), keys.end(),
+                       [](const BuildKey &a, const BuildKey &b) { return a.id == b.id; });
+    report.duplicates = keys.end() - last;
+    keys.erase(last, keys.end());
+    report.students = keys.size();
+
+    auto sorted = chrono::steady_clock::now();
+    report.sortSeconds = chrono::duration<double>(sorted - start).count();
+    if (keys.empty()) return nullptr;
+
+    TreeNode* nodes = static_cast<TreeNode*>(::operator new(keys.size() * sizeof(TreeNode)));
+    g_nodeArenas.push_back({nodes, keys.size()});
+    TreeNode* root = buildBalanced(keys, students, nodes, 0, keys.size(), threads);
+    report.buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - sorted).count();
+    return root;
 }
 
 // --------- Show a single student's info ---------
@@ -126,23 +950,31 @@ void showMenu() {
     cout << "1. Enter new student\n";
     cout << "2. Search student by ID\n";
     cout << "3. Insert marks\n";
-    cout << "4. Exit\n";
+    cout << "4. Apply marks from a results file\n";
+    cout << "5. Memory usage report\n";
+    cout << "6. Parallel registration import\n";
+    cout << "7. Rebuild as balanced tree\n";
+    cout << "8. Operation latency report\n";
+    cout << "9. Exit\n";
     cout << "Enter your choice: ";
 }
 
 // --------- Option 1: Enter new student ---------
-void menuEnterNewStudent(TreeNode*& root) {
+void menuEnterNewStudent(atomic<TreeNode*>& root) {
     while (true) {
         Student s;
 
         cout << "\n--- Enter New Student ---\n";
         s.id = readInt("Enter student ID (integer): ");
 
+        string line;
         cout << "Enter name   : ";
-        getline(cin, s.name);
+        getline(cin, line);
+        s.name = line;
 
         cout << "Enter course : ";
-        getline(cin, s.course);
+        getline(cin, line);
+        s.course = line;
 
         // Enter multiple subjects
         cout << "\nNow enter subjects for this student.\n";
@@ -151,7 +983,8 @@ void menuEnterNewStudent(TreeNode*& root) {
         while (true) {
             SubjectRecord sub;
             cout << "Enter subject name (or 0 to finish): ";
-            getline(cin, sub.name);
+            getline(cin, line);
+            sub.name = line;
 
             if (sub.name == "0") {
                 if (s.subjects.empty()) {
@@ -164,11 +997,16 @@ void menuEnterNewStudent(TreeNode*& root) {
 
             sub.hasMark = false;
             sub.mark = 0.0;
-            s.subjects.push_back(sub);
+            s.subjects.push_back(move(sub));
         }
 
         int steps = 0;  // Initialize steps counter
-        insertStudent(root, s, steps);
+        int id = s.id;
+        if (insertStudent(root, move(s), steps)) {
+            cout << "Student with ID " << id << " has been added successfully.\n";
+        } else {
+            cout << "ID " << id << " already exists in the system.\n";
+        }
 
         cout << "Steps taken to insert the student: " << steps << "\n";
 
@@ -272,16 +1110,514 @@ void menuInsertMarks(TreeNode* root) {
     }
 }
 
+// --------- Bulk mark updates: sort the batch, then one in-order walk ---------
+// The batch is sorted by ID and the tree is walked in order alongside it, so
+// a results file costs one traversal instead of one search per mark.
+struct MarkUpdate {
+    int id;
+    string subject;
+    double mark;
+};
+
+struct BulkUpdateReport {
+    size_t marksApplied = 0;
+    size_t studentsUpdated = 0;
+    vector<int> unmatchedIds;                      // each unknown ID once
+    vector<pair<int, string>> unmatchedSubjects;   // subject not registered for that student
+};
+
+BulkUpdateReport applyMarkUpdates(TreeNode* root, vector<MarkUpdate> updates) {
+    BulkUpdateReport report;
+
+    // Stable, so a later line for the same ID and subject wins.
+    stable_sort(updates.begin(), updates.end(),
+                [](const MarkUpdate &a, const MarkUpdate &b) { return a.id < b.id; });
+
+    // Each student's new marks are built on a copy and published in one step.
+    EpochGuard guard;
+    size_t i = 0;
+    forEachNode(root, [&](TreeNode* node) {
+        int id = node->student.id;
+
+        // Updates for IDs smaller than this student have no match in the tree
+        while (i < updates.size() && updates[i].id < id) {
+            int missing = updates[i].id;
+            report.unmatchedIds.push_back(missing);
+            while (i < updates.size() && updates[i].id == missing) i++;
+        }
+        if (i == updates.size() || updates[i].id != id) return i < updates.size();
+
+        SubjectList subjects = currentSubjects(node);
+        size_t applied = 0;
+        for (; i < updates.size() && updates[i].id == id; ++i) {
+            bool matched = false;
+            for (SubjectRecord &sub : subjects) {
+                if (string_view(sub.name) == updates[i].subject) {
+                    sub.mark = updates[i].mark;
+                    sub.hasMark = true;
+                    matched = true;
+                    break;
+                }
+            }
+            if (matched) applied++;
+            else report.unmatchedSubjects.push_back({id, updates[i].subject});
+        }
+        if (applied > 0) {
+            publishSubjects(node, move(subjects));
+            report.marksApplied += applied;
+            report.studentsUpdated++;
+        }
+        return i < updates.size();
+    });
+
+    // Everything past the largest ID in the tree
+    while (i < updates.size()) {
+        int id = updates[i].id;
+        report.unmatchedIds.push_back(id);
+        while (i < updates.size() && updates[i].id == id) i++;
+    }
+    return report;
+}
+
+// Parse one "id,subject,mark" line. Exported results often pad fields or
+// separate them with spaces instead, so whitespace around fields is ignored
+// and a line with no comma is read as "id subject words... mark".
+bool parseMarkUpdate(string line, MarkUpdate &update) {
+    const char *spaces = " \t\r";
+    line.erase(line.find_last_not_of(spaces) + 1); // trailing spaces and CR
+    size_t first = line.find(',');
+    size_t last = line.rfind(',');
+    if (first == string::npos) {
+        first = line.find_first_of(spaces);
+        last = line.find_last_of(spaces);
+    }
+    if (first == string::npos || first == last) return false;
+
+    char *end = nullptr;
+    long id = strtol(line.c_str(), &end, 10);
+    if (end == line.c_str() || line.find_first_not_of(spaces, end - line.c_str()) < first) return false;
+
+    const char *markText = line.c_str() + last + 1;
+    char *markEnd = nullptr;
+    double mark = strtod(markText, &markEnd);
+    if (markEnd == markText || line.find_first_not_of(spaces, markEnd - line.c_str()) != string::npos) return false;
+
+    size_t nameStart = line.find_first_not_of(spaces, first + 1);
+    size_t nameEnd = line.find_last_not_of(spaces, last - 1);
+    if (nameStart == string::npos || nameStart >= last || nameEnd < nameStart) return false;
+
+    update = MarkUpdate{static_cast<int>(id), line.substr(nameStart, nameEnd - nameStart + 1), mark};
+    return true;
+}
+
+// Read a results file. Blank lines and lines starting with # are skipped;
+// the numbers of lines that do not parse are returned in badLines.
+bool readMarkUpdates(const string &fileName, vector<MarkUpdate> &updates, vector<size_t> &badLines) {
+    ifstream in(fileName);
+    if (!in) return false;
+
+    badLines.clear();
+    string line;
+    size_t lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        size_t content = line.find_first_not_of(" \t\r");
+        if (content == string::npos || line[content] == '#') continue;
+
+        MarkUpdate update;
+        if (parseMarkUpdate(line, update)) {
+            updates.push_back(move(update));
+        } else {
+            badLines.push_back(lineNumber);
+        }
+    }
+    return true;
+}
+
+// --------- Option 4: Apply marks from a results file ---------
+void menuBulkMarkUpdate(TreeNode* root) {
+    if (root == nullptr) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Apply Marks from Results File ---\n";
+        cout << "Each line: student ID,subject name,mark (or separated by spaces)\n";
+        cout << "Enter file name: ";
+        string fileName;
+        getline(cin, fileName);
+
+        vector<MarkUpdate> updates;
+        vector<size_t> badLines;
+        if (!readMarkUpdates(fileName, updates, badLines)) {
+            cout << "Could not open " << fileName << "\n";
+        } else {
+            auto start = chrono::steady_clock::now();
+            BulkUpdateReport report = applyMarkUpdates(root, move(updates));
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            cout << report.marksApplied << " marks applied to " << report.studentsUpdated
+                 << " students in " << seconds * 1000.0 << " ms\n";
+            if (!badLines.empty()) {
+                cout << badLines.size() << " line(s) could not be read and were skipped";
+                for (size_t i = 0; i < badLines.size() && i < 10; ++i) {
+                    cout << (i == 0 ? ": line " : ", ") << badLines[i];
+                }
+                cout << (badLines.size() > 10 ? ", ...\n" : "\n");
+            }
+
+            cout << report.unmatchedIds.size() << " unknown student ID(s)";
+            for (size_t i = 0; i < report.unmatchedIds.size() && i < 10; ++i) {
+                cout << (i == 0 ? ": " : ", ") << report.unmatchedIds[i];
+            }
+            cout << (report.unmatchedIds.size() > 10 ? ", ...\n" : "\n");
+
+            cout << report.unmatchedSubjects.size() << " mark(s) for subjects the student does not take";
+            for (size_t i = 0; i < report.unmatchedSubjects.size() && i < 10; ++i) {
+                cout << (i == 0 ? ": " : ", ") << report.unmatchedSubjects[i].first
+                     << "/" << report.unmatchedSubjects[i].second;
+            }
+            cout << (report.unmatchedSubjects.size() > 10 ? ", ...\n" : "\n");
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Apply another file\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                break;
+            } else if (choice == 2) {
+                return;
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Memory accounting ---------
+// Where the tree's bytes go. Every byte is in exactly one category:
+//   payload  - the data itself: IDs, text characters, marks
+//   index    - bytes that only exist to find students (child links)
+//   slack    - reserved but unused: unused inline space, allocator rounding
+//   overhead - the rest: size fields, pointers, padding, block headers
+struct MemoryReport {
+    size_t students = 0;
+    size_t total = 0;
+    size_t payload = 0;
+    size_t index = 0;
+    size_t slack = 0;
+
+    size_t overhead() const { return total - payload - index - slack; }
+};
+
+template <size_t N>
+void accountText(MemoryReport &report, const InlineString<N> &text) {
+    report.payload += text.size();
+    if (text.onHeap()) {
+        size_t block = heapBlockBytes(text.data());
+        report.total += block;
+        report.slack += N + (block - MALLOC_CHUNK_HEADER - text.size() - 1);
+    } else {
+        report.slack += N - 1 - text.size();
+    }
+}
+
+// A subject list whose SubjectList object is counted by its holder. A list
+// replaced by a marks update is all slack.
+void accountSubjects(MemoryReport &report, const SubjectList &subjects, bool current) {
+    size_t spill = subjects.onHeap() ? heapBlockBytes(subjects.begin()) : 0;
+    report.total += spill;
+    if (!current) {
+        report.slack += SubjectList::INLINE_CAPACITY * sizeof(SubjectRecord) + spill;
+        for (const SubjectRecord &sub : subjects) {
+            if (sub.name.onHeap()) {
+                size_t block = heapBlockBytes(sub.name.data());
+                report.total += block;
+                report.slack += block;
+            }
+        }
+        return;
+    }
+
+    if (subjects.onHeap()) {
+        report.slack += SubjectList::INLINE_CAPACITY * sizeof(SubjectRecord); // unused inline slots
+        report.slack += spill - MALLOC_CHUNK_HEADER - subjects.size() * sizeof(SubjectRecord);
+    } else {
+        report.slack += (subjects.capacity() - subjects.size()) * sizeof(SubjectRecord);
+    }
+    for (const SubjectRecord &sub : subjects) {
+        report.payload += sizeof(sub.mark) + sizeof(sub.hasMark);
+        accountText(report, sub.name);
+    }
+}
+
+MemoryReport memoryReport(TreeNode* root) {
+    MemoryReport report;
+    EpochGuard guard;
+
+    forEachNode(root, [&](TreeNode* node) {
+        const Student &s = node->student;
+        report.students++;
+        report.index += sizeof(node->left) + sizeof(node->right);
+        if (!inNodeArena(node)) { // arena blocks are counted once, below
+            size_t block = heapBlockBytes(node);
+            report.total += block;
+            report.slack += block - MALLOC_CHUNK_HEADER - sizeof(TreeNode);
+        }
+
+        report.payload += sizeof(s.id);
+        accountText(report, s.name);
+        accountText(report, s.course);
+
+        const SubjectList *marks = node->marks.load(memory_order_acquire);
+        accountSubjects(report, s.subjects, marks == nullptr);
+        if (marks != nullptr) {
+            size_t listBlock = heapBlockBytes(marks);
+            report.total += listBlock;
+            report.slack += listBlock - MALLOC_CHUNK_HEADER - sizeof(SubjectList);
+            accountSubjects(report, *marks, true);
+        }
+        return true;
+    });
+
+    for (const NodeArena &arena : g_nodeArenas) {
+        size_t block = heapBlockBytes(arena.nodes);
+        report.total += block;
+        report.slack += block - MALLOC_CHUNK_HEADER - arena.count * sizeof(TreeNode);
+    }
+    return report;
+}
+
+// --------- Option 5: Memory usage report ---------
+void menuMemoryReport(TreeNode* root) {
+    MemoryReport report = memoryReport(root);
+    auto line = [&](const char *label, size_t bytes) {
+        cout << label << bytes << " bytes";
+        if (report.total > 0) cout << " (" << 100.0 * bytes / report.total << "%)";
+        cout << "\n";
+    };
+
+    cout << "\n--- Memory Usage ---\n";
+    cout << "Students      : " << report.students << "\n";
+    cout << "Total         : " << report.total << " bytes";
+    if (report.students > 0) cout << ", " << static_cast<double>(report.total) / report.students << " per student";
+    cout << "\n";
+    line("  Payload     : ", report.payload);
+    line("  Index       : ", report.index);
+    line("  Overhead    : ", report.overhead());
+    line("  Slack       : ", report.slack);
+    cout << "Heap (tracked): " << g_heapBytes.load() << " bytes in " << g_heapBlocks.load() << " blocks\n";
+}
+
+// A made-up student with four subjects, for imports and bulk builds
+Student generatedStudent(int id) {
+    Student s;
+    s.id = id;
+    s.name = "Student " + to_string(id);
+    s.course = "Course " + to_string(id % 20);
+    for (int k = 0; k < 4; ++k) {
+        SubjectRecord sub;
+        sub.name = "Subject " + to_string((id + k) % 30);
+        sub.hasMark = false;
+        sub.mark = 0.0;
+        s.subjects.push_back(move(sub));
+    }
+    return s;
+}
+
+// --------- Option 6: Parallel registration import ---------
+// Several threads insert generated students into the live tree at once, the
+// way registration desks would. IDs are random, so some collide with each
+// other or with students already in the tree and are rejected.
+void menuParallelImport(atomic<TreeNode*>& root) {
+    while (true) {
+        cout << "\n--- Parallel Registration Import ---\n";
+        int count = readInt("How many students to import: ");
+        int threads = readInt("How many threads: ");
+        if (count < 1 || threads < 1 || threads > MAX_EPOCH_THREADS) {
+            cout << "Please enter at least 1 student and 1 to " << MAX_EPOCH_THREADS << " threads.\n";
+            continue;
+        }
+
+        atomic<long long> added(0);
+        atomic<long long> totalSteps(0);
+        auto start = chrono::steady_clock::now();
+
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                mt19937 rng(12345u + t);
+                uniform_int_distribution<int> idDist(1, max(count * 10, 100));
+                long long myAdded = 0, mySteps = 0;
+
+                for (int i = t; i < count; i += threads) {
+                    Student s = generatedStudent(idDist(rng));
+                    int steps = 0;
+                    if (insertStudent(root, move(s), steps)) myAdded++;
+                    mySteps += steps;
+                }
+                added += myAdded;
+                totalSteps += mySteps;
+            });
+        }
+        for (thread &w : workers) w.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        // The tree must still be a valid BST after the concurrent inserts
+        size_t total = 0;
+        int previous = numeric_limits<int>::min();
+        bool ordered = true;
+        forEachNode(root.load(), [&](TreeNode* node) {
+            if (total > 0 && node->student.id <= previous) ordered = false;
+            previous = node->student.id;
+            total++;
+            return true;
+        });
+
+        cout << added.load() << " students added, " << (count - added.load())
+             << " rejected as duplicate IDs, in " << seconds * 1000.0 << " ms ("
+             << count / seconds << " inserts/s with " << threads << " threads)\n";
+        cout << "Average steps per insert: " << static_cast<double>(totalSteps.load()) / count << "\n";
+        cout << "Students in tree: " << total << ", order check " << (ordered ? "passed" : "FAILED") << "\n";
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Import another batch\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                break; // loop again
+            } else if (choice == 2) {
+                return;
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 7: Rebuild as a balanced tree ---------
+// Every student in the tree, plus an optional batch of generated ones, is
+// bulk-built into a new balanced tree that replaces the old one.
+void menuBulkBuild(atomic<TreeNode*>& root) {
+    while (true) {
+        cout << "\n--- Rebuild Balanced Tree ---\n";
+        int count = readInt("How many new students to add (0 = only rebalance): ");
+        int threads = readInt("How many threads: ");
+        if (count < 0 || threads < 1 || threads > MAX_EPOCH_THREADS) {
+            cout << "Please enter 0 or more students and 1 to " << MAX_EPOCH_THREADS << " threads.\n";
+            continue;
+        }
+
+        // Take the students out of the old tree; they keep priority over new
+        // copies of the same ID. Nothing else runs while the menu does.
+        TreeNode* old = root.load();
+        size_t heightBefore = treeHeight(old);
+        vector<Student> students;
+        forEachNode(old, [&](TreeNode* node) {
+            Student s;
+            s.id = node->student.id;
+            s.name = move(node->student.name);
+            s.course = move(node->student.course);
+            SubjectList *marks = node->marks.load();
+            s.subjects = marks != nullptr ? move(*marks) : move(node->student.subjects);
+            students.push_back(move(s));
+            return true;
+        });
+        destroyTree(old);
+        root.store(nullptr);
+
+        mt19937 rng(2024);
+        uniform_int_distribution<int> idDist(1, max(count * 10, 100));
+        students.reserve(students.size() + count);
+        for (int i = 0; i < count; ++i) {
+            students.push_back(generatedStudent(idDist(rng)));
+        }
+
+        BulkBuildReport report;
+        root.store(buildBalancedTree(students, threads, report), memory_order_release);
+
+        size_t minHeight = 0;
+        while ((size_t(1) << minHeight) <= report.students) minHeight++;
+        cout << report.students << " students in the tree, " << report.duplicates << " duplicate IDs dropped\n";
+        cout << "Sort: " << report.sortSeconds * 1000.0 << " ms, build: " << report.buildSeconds * 1000.0
+             << " ms with " << threads << " threads\n";
+        cout << "Height: " << heightBefore << " before, " << treeHeight(root.load())
+             << " now (minimum " << minHeight << ")\n";
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Rebuild again\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                break; // loop again
+            } else if (choice == 2) {
+                return;
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 8: Operation latency report ---------
+void menuLatencyReport() {
+    while (true) {
+        cout << "\n--- Operation Latency ---\n";
+        g_flightRecorder.printReport(cout);
+
+        int choice = readInt(
+            "\nWhat do you want to do next?\n"
+            "1. Write the slowest operations as a Chrome trace file\n"
+            "2. Reset\n"
+            "3. Return to main menu\n"
+            "Enter your choice: "
+        );
+
+        if (choice == 1) {
+            string fileName;
+            cout << "Enter output file name: ";
+            getline(cin, fileName);
+            ofstream out(fileName);
+            g_flightRecorder.writeChromeTrace(out);
+            if (out) cout << "Trace written to " << fileName << " (open it in chrome://tracing or ui.perfetto.dev)\n";
+            else cout << "Could not write " << fileName << "\n";
+        } else if (choice == 2) {
+            g_flightRecorder.reset();
+        } else if (choice == 3) {
+            return;
+        } else {
+            cout << "Wrong input, please enter another input (1–3).\n";
+        }
+    }
+}
+
 // --------- main ---------
 int main() {
-    TreeNode* root = nullptr; // Start with an empty BST
+    atomic<TreeNode*> root(nullptr); // Start with an empty BST; registration threads link into it
     int choice;
 
     while (true) {
         showMenu();
 
         if (!(cin >> choice)) {
-            cout << "Wrong input, please enter another input (1–4).\n";
+            cout << "Wrong input, please enter another input (1–9).\n";
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             continue;
@@ -293,16 +1629,31 @@ int main() {
                 menuEnterNewStudent(root);
                 break;
             case 2:
-                menuSearchStudent(root);
+                menuSearchStudent(root.load());
                 break;
             case 3:
-                menuInsertMarks(root);
+                menuInsertMarks(root.load());
                 break;
             case 4:
+                menuBulkMarkUpdate(root.load());
+                break;
+            case 5:
+                menuMemoryReport(root.load());
+                break;
+            case 6:
+                menuParallelImport(root);
+                break;
+            case 7:
+                menuBulkBuild(root);
+                break;
+            case 8:
+                menuLatencyReport();
+                break;
+            case 9:
                 cout << "\nExiting program. Goodbye!\n";
                 return 0;
             default:
-                cout << "Wrong input, please enter another input (1–4).\n";
+                cout << "Wrong input, please enter another input (1–9).\n";
                 break;
         }
     }
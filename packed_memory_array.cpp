@@ -0,0 +1,525 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <chrono>
+#include <random>
+
+using namespace std;
+
+// --------- Subject and Student structures ---------
+struct SubjectRecord {
+    string name;
+    double mark;
+    bool hasMark;
+};
+
+struct Student {
+    int id;
+    string name;
+    string course;
+    vector<SubjectRecord> subjects;
+};
+
+// --------- Packed Memory Array (sorted array with gaps) ---------
+// The array is cut into segments of about log2(capacity) slots. Students are
+// kept sorted across segments and packed to the left inside each segment, so
+// the free slots of a segment are at its end. An insert shifts at most one
+// segment. When a segment is full, the smallest enclosing window of 2, 4, 8...
+// segments that is still below its density limit is spread out evenly again;
+// limits are loosest for single segments and strictest for the whole array.
+// This gives O(log^2 n) amortized moves per insert instead of O(n).
+class PackedStudentArray {
+private:
+    vector<Student> m_slots;
+    vector<int> m_segCount;   // students in each segment
+    int m_segSize = 8;        // slots per segment (a power of two)
+    size_t m_size = 0;
+    long long m_moves = 0;    // students moved by inserts, for analysis
+
+    // Density limits: a single segment may be full, the whole array 75% full.
+    static constexpr double LEAF_LIMIT = 1.0;
+    static constexpr double ROOT_LIMIT = 0.75;
+
+    int segments() const { return static_cast<int>(m_segCount.size()); }
+
+    // Allowed density for a window `level` doublings above one segment
+    double limitAt(int level) const {
+        int height = 0;
+        while ((1 << height) < segments()) height++;
+        if (height == 0) return LEAF_LIMIT;
+        return LEAF_LIMIT - (LEAF_LIMIT - ROOT_LIMIT) * level / height;
+    }
+
+    // Segment that should hold targetId: the last non-empty segment whose
+    // first ID is <= targetId (0 if none).
+    int segmentFor(int targetId, int &steps) const {
+        int left = 0;
+        int right = segments() - 1;
+        int found = 0;
+        while (left <= right) {
+            steps++;
+            int mid = left + (right - left) / 2;
+            int probe = mid;
+            while (probe >= left && m_segCount[probe] == 0) probe--; // skip empty segments
+            if (probe < left) {
+                left = mid + 1;
+                continue;
+            }
+            if (m_slots[static_cast<size_t>(probe) * m_segSize].id <= targetId) {
+                found = probe;
+                left = mid + 1;
+            } else {
+                right = probe - 1;
+            }
+        }
+        return found;
+    }
+
+    // Spread `pending` (sorted) evenly over segments [first, first + count).
+    void spread(vector<Student> &pending, int first, int count) {
+        size_t total = pending.size();
+        size_t next = 0;
+        for (int i = 0; i < count; ++i) {
+            size_t share = total / count + (static_cast<size_t>(i) < total % count ? 1 : 0);
+            size_t base = static_cast<size_t>(first + i) * m_segSize;
+            for (size_t k = 0; k < share; ++k) {
+                m_slots[base + k] = move(pending[next++]);
+            }
+            m_segCount[first + i] = static_cast<int>(share);
+        }
+        m_moves += static_cast<long long>(total);
+    }
+
+    // Move all students of segments [first, first + count) out, in order,
+    // with newStudent merged into its place.
+    vector<Student> gather(int first, int count, Student &&newStudent) {
+        vector<Student> pending;
+        bool placed = false;
+        for (int i = first; i < first + count; ++i) {
+            size_t base = static_cast<size_t>(i) * m_segSize;
+            for (int k = 0; k < m_segCount[i]; ++k) {
+                Student &s = m_slots[base + k];
+                if (!placed && newStudent.id < s.id) {
+                    pending.push_back(move(newStudent));
+                    placed = true;
+                }
+                pending.push_back(move(s));
+            }
+        }
+        if (!placed) pending.push_back(move(newStudent));
+        return pending;
+    }
+
+    // Double the capacity and spread everything (plus newStudent) evenly.
+    void grow(Student &&newStudent) {
+        vector<Student> pending = gather(0, segments(), move(newStudent));
+
+        size_t capacity = m_slots.size() * 2;
+        int log2Capacity = 0;
+        while ((static_cast<size_t>(1) << log2Capacity) < capacity) log2Capacity++;
+        int segSize = 8;
+        while (segSize < log2Capacity) segSize *= 2; // a power of two near log2(capacity)
+        m_segSize = segSize;
+        m_slots.assign(capacity, Student());
+        m_segCount.assign(capacity / segSize, 0);
+        spread(pending, 0, segments());
+    }
+
+public:
+    PackedStudentArray() {
+        m_slots.resize(m_segSize);
+        m_segCount.assign(1, 0);
+    }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_slots.size(); }
+    long long moves() const { return m_moves; }
+
+    // Slot of the student, or -1. Slots stay valid until the next insert.
+    int find(int targetId, int &steps) const {
+        steps = 0;
+        if (m_size == 0) return -1;
+
+        int seg = segmentFor(targetId, steps);
+        size_t base = static_cast<size_t>(seg) * m_segSize;
+        int left = 0;
+        int right = m_segCount[seg] - 1;
+        while (left <= right) {
+            steps++;
+            int mid = left + (right - left) / 2;
+            int id = m_slots[base + mid].id;
+            if (id == targetId) return static_cast<int>(base + mid);
+            if (targetId < id) right = mid - 1;
+            else left = mid + 1;
+        }
+        return -1;
+    }
+
+    Student &at(int slot) { return m_slots[slot]; }
+    const Student &at(int slot) const { return m_slots[slot]; }
+
+    // Insert keeping ID order. Returns false if the ID already exists.
+    bool insert(Student &&newStudent) {
+        int steps = 0;
+        if (find(newStudent.id, steps) != -1) return false;
+
+        int seg = segmentFor(newStudent.id, steps);
+        m_size++;
+
+        // Room in the segment: shift the larger IDs one slot right.
+        if (m_segCount[seg] < m_segSize) {
+            size_t base = static_cast<size_t>(seg) * m_segSize;
+            int k = m_segCount[seg];
+            while (k > 0 && m_slots[base + k - 1].id > newStudent.id) {
+                m_slots[base + k] = move(m_slots[base + k - 1]);
+                k--;
+                m_moves++;
+            }
+            m_slots[base + k] = move(newStudent);
+            m_segCount[seg]++;
+            m_moves++;
+            return true;
+        }
+
+        // Segment full: find the smallest window that can absorb one more.
+        for (int level = 1, width = 2; width <= segments(); ++level, width *= 2) {
+            int first = seg / width * width;
+            long long used = 1;
+            for (int i = first; i < first + width; ++i) used += m_segCount[i];
+            if (used <= limitAt(level) * width * m_segSize) {
+                vector<Student> pending = gather(first, width, move(newStudent));
+                spread(pending, first, width);
+                return true;
+            }
+        }
+
+        grow(move(newStudent));
+        return true;
+    }
+
+    // Visit every student in ID order.
+    template <typename Visitor>
+    void forEachStudent(Visitor visit) const {
+        for (int i = 0; i < segments(); ++i) {
+            size_t base = static_cast<size_t>(i) * m_segSize;
+            for (int k = 0; k < m_segCount[i]; ++k) {
+                visit(m_slots[base + k]);
+            }
+        }
+    }
+};
+
+// --------- Helper: safely read an integer ---------
+int readInt(const string &prompt) {
+    int value;
+    while (true) {
+        cout << prompt;
+        if (cin >> value) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
+            return value;
+        } else {
+            cout << "Wrong input, please enter another input (integer).\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+}
+
+// --------- Helper: safely read a double ---------
+double readDouble(const string &prompt) {
+    double value;
+    while (true) {
+        cout << prompt;
+        if (cin >> value) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
+            return value;
+        } else {
+            cout << "Wrong input, please enter another input (number).\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+}
+
+// --------- Show a single student's info ---------
+void showStudent(const Student &s) {
+    cout << "\n=== Student Information ===\n";
+    cout << "ID     : " << s.id << "\n";
+    cout << "Name   : " << s.name << "\n";
+    cout << "Course : " << s.course << "\n";
+    cout << "Subjects and Marks:\n";
+
+    if (s.subjects.empty()) {
+        cout << "  (No subjects registered)\n";
+    } else {
+        for (size_t i = 0; i < s.subjects.size(); ++i) {
+            cout << "  " << (i + 1) << ". " << s.subjects[i].name << " - ";
+            if (s.subjects[i].hasMark) {
+                cout << s.subjects[i].mark;
+            } else {
+                cout << "(no mark yet)";
+            }
+            cout << "\n";
+        }
+    }
+
+    cout << "===========================\n";
+}
+
+// --------- Menu display ---------
+void showMenu() {
+    cout << "\n==============================\n";
+    cout << "  Student ID Search System\n";
+    cout << "  (Packed Memory Array + Binary Search)\n";
+    cout << "==============================\n";
+    cout << "1. Enter new student\n";
+    cout << "2. Search student by ID\n";
+    cout << "3. Insert marks\n";
+    cout << "4. Insert benchmark (PMA vs sorted vector)\n";
+    cout << "5. Exit\n";
+    cout << "Enter your choice: ";
+}
+
+// --------- Option 1: Enter new student (with many subjects) ---------
+void menuEnterNewStudent(PackedStudentArray &students) {
+    while (true) {
+        Student s;
+
+        cout << "\n--- Enter New Student ---\n";
+        s.id = readInt("Enter student ID (integer): ");
+
+        cout << "Enter name   : ";
+        getline(cin, s.name);
+
+        cout << "Enter course : ";
+        getline(cin, s.course);
+
+        // Enter multiple subjects
+        cout << "\nNow enter subjects for this student.\n";
+        cout << "Press \"Enter\" to add new subject or press \"0\" when you are done.\n";
+
+        while (true) {
+            SubjectRecord sub;
+            cout << "Enter subject name (or 0 to finish): ";
+            getline(cin, sub.name);
+
+            if (sub.name == "0") {
+                if (s.subjects.empty()) {
+                    cout << "Student must have at least one subject.\n";
+                    continue;
+                } else {
+                    break;
+                }
+            }
+
+            sub.hasMark = false;
+            sub.mark = 0.0;
+            s.subjects.push_back(sub);
+        }
+
+        int id = s.id;
+        if (students.insert(move(s))) {
+            cout << "Student with ID " << id << " has been added successfully.\n";
+        } else {
+            cout << "ID " << id << " already exists in the system.\n";
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Enter another student\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                // loop again to add another student
+                break;
+            } else if (choice == 2) {
+                return; // back to main menu
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 2: Search student by ID ---------
+void menuSearchStudent(const PackedStudentArray &students) {
+    if (students.size() == 0) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Search Student by ID ---\n";
+        int targetId = readInt("Enter student ID to search: ");
+        int steps = 0; // Initialize steps counter
+
+        int slot = students.find(targetId, steps);
+        if (slot != -1) {
+            showStudent(students.at(slot));
+            cout << "Steps taken to find the student: " << steps << "\n";
+        } else {
+            cout << "ID " << targetId << " not found in the system.\n";
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Search another ID\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                // loop again to search another ID
+                break;
+            } else if (choice == 2) {
+                return; // back to main menu
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 3: Insert marks for subjects ---------
+void menuInsertMarks(PackedStudentArray &students) {
+    if (students.size() == 0) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Insert Marks ---\n";
+        int targetId = readInt("Enter student ID to insert marks: ");
+
+        int steps = 0;
+        int slot = students.find(targetId, steps);
+        if (slot == -1) {
+            cout << "ID " << targetId << " not found in the system.\n";
+        } else {
+            Student &s = students.at(slot);
+            cout << "\nInserting marks for student:\n";
+            showStudent(s);
+            cout << "\nEnter marks for each subject.\n";
+
+            for (size_t i = 0; i < s.subjects.size(); ++i) {
+                cout << "\nSubject " << (i + 1) << ": " << s.subjects[i].name << "\n";
+                double mark = readDouble("Enter mark: ");
+                s.subjects[i].mark = mark;
+                s.subjects[i].hasMark = true;
+            }
+
+            cout << "\nAll marks updated for this student.\n";
+            showStudent(s);
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Insert marks for another ID\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                break; // loop again
+            } else if (choice == 2) {
+                return;
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 4: Time random inserts into a PMA and a sorted vector ---------
+void menuInsertBenchmark() {
+    int count = readInt("\nHow many random students to insert: ");
+    if (count <= 0) {
+        cout << "Nothing to insert.\n";
+        return;
+    }
+
+    mt19937 rng(12345);
+    vector<int> ids(count);
+    for (int &id : ids) id = static_cast<int>(rng() % 2000000000);
+
+    PackedStudentArray pma;
+    auto start = chrono::steady_clock::now();
+    for (int id : ids) {
+        Student s;
+        s.id = id;
+        s.name = "Benchmark";
+        s.course = "Benchmark";
+        pma.insert(move(s));
+    }
+    double pmaSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<Student> sorted;
+    start = chrono::steady_clock::now();
+    for (int id : ids) {
+        auto pos = lower_bound(sorted.begin(), sorted.end(), id,
+                               [](const Student &s, int value) { return s.id < value; });
+        if (pos != sorted.end() && pos->id == id) continue;
+        Student s;
+        s.id = id;
+        s.name = "Benchmark";
+        s.course = "Benchmark";
+        sorted.insert(pos, move(s));
+    }
+    double vectorSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Packed memory array : " << pmaSeconds * 1000.0 << " ms, "
+         << static_cast<double>(pma.moves()) / pma.size() << " moves per insert, "
+         << pma.size() << " students in " << pma.capacity() << " slots\n";
+    cout << "Sorted vector       : " << vectorSeconds * 1000.0 << " ms\n";
+}
+
+// --------- main ---------
+int main() {
+    PackedStudentArray students;
+    int choice;
+
+    while (true) {
+        showMenu();
+
+        if (!(cin >> choice)) {
+            cout << "Wrong input, please enter another input (1–5).\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
+
+        switch (choice) {
+            case 1:
+                menuEnterNewStudent(students);
+                break;
+            case 2:
+                menuSearchStudent(students);
+                break;
+            case 3:
+                menuInsertMarks(students);
+                break;
+            case 4:
+                menuInsertBenchmark();
+                break;
+            case 5:
+                cout << "\nExiting program. Goodbye!\n";
+                return 0;
+            default:
+                cout << "Wrong input, please enter another input (1–5).\n";
+                break;
+        }
+    }
+
+    return 0;
+}
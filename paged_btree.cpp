@@ -0,0 +1,989 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <unordered_map>
+#include <limits>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <chrono>
+#include <random>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// --------- Subject and Student structures ---------
+struct SubjectRecord {
+    string name;
+    double mark;
+    bool hasMark;
+};
+
+struct Student {
+    int id;
+    string name;
+    string course;
+    vector<SubjectRecord> subjects;
+};
+
+// --------- On-disk record layout ---------
+// Every student occupies one fixed-size record so a leaf page holds a fixed
+// number of them. Text is stored zero-terminated; the limits below are
+// checked when a student is entered.
+const size_t NAME_CAPACITY = 40;
+const size_t COURSE_CAPACITY = 32;
+const size_t SUBJECT_NAME_CAPACITY = 24;
+const size_t MAX_SUBJECTS = 8;
+
+struct SubjectSlot {
+    char name[SUBJECT_NAME_CAPACITY];
+    double mark;
+    int32_t hasMark;
+    int32_t unused;
+};
+
+struct StudentRecord {
+    int32_t id;
+    int32_t subjectCount;
+    char name[NAME_CAPACITY];
+    char course[COURSE_CAPACITY];
+    SubjectSlot subjects[MAX_SUBJECTS];
+};
+
+void copyText(char *dest, size_t capacity, const string &text) {
+    size_t length = min(text.size(), capacity - 1);
+    memcpy(dest, text.data(), length);
+    memset(dest + length, 0, capacity - length);
+}
+
+StudentRecord toRecord(const Student &s) {
+    StudentRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.id = s.id;
+    rec.subjectCount = static_cast<int32_t>(min(s.subjects.size(), MAX_SUBJECTS));
+    copyText(rec.name, NAME_CAPACITY, s.name);
+    copyText(rec.course, COURSE_CAPACITY, s.course);
+    for (int i = 0; i < rec.subjectCount; ++i) {
+        copyText(rec.subjects[i].name, SUBJECT_NAME_CAPACITY, s.subjects[i].name);
+        rec.subjects[i].mark = s.subjects[i].mark;
+        rec.subjects[i].hasMark = s.subjects[i].hasMark ? 1 : 0;
+    }
+    return rec;
+}
+
+Student fromRecord(const StudentRecord &rec) {
+    Student s;
+    s.id = rec.id;
+    s.name = string(rec.name, strnlen(rec.name, NAME_CAPACITY));
+    s.course = string(rec.course, strnlen(rec.course, COURSE_CAPACITY));
+    for (int i = 0; i < rec.subjectCount; ++i) {
+        const SubjectSlot &slot = rec.subjects[i];
+        s.subjects.push_back(SubjectRecord{
+            string(slot.name, strnlen(slot.name, SUBJECT_NAME_CAPACITY)), slot.mark, slot.hasMark != 0});
+    }
+    return s;
+}
+
+// --------- Page layouts ---------
+// Page 0 is the file header. Every other page is a B+tree node: leaves hold
+// the student records sorted by ID, inner nodes hold separator keys and child
+// page numbers. Child i of an inner node holds the IDs in
+// [keys[i - 1], keys[i]).
+const size_t PAGE_SIZE = 4096;
+const char FILE_MAGIC[8] = {'S', 'T', 'U', 'B', 'T', 'R', 'E', '1'};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t pageSize;
+    uint32_t root;
+    uint32_t pageCount;
+    uint32_t height;      // 1 when the root is a leaf
+    uint64_t studentCount;
+};
+
+struct NodeHeader {
+    uint16_t isLeaf;
+    uint16_t count;       // records in a leaf, keys in an inner node
+    uint32_t unused[3];
+};
+
+const size_t LEAF_CAPACITY = (PAGE_SIZE - sizeof(NodeHeader)) / sizeof(StudentRecord);
+const size_t INNER_CAPACITY = (PAGE_SIZE - sizeof(NodeHeader) - sizeof(uint32_t)) / (sizeof(int32_t) + sizeof(uint32_t));
+
+struct LeafPage {
+    NodeHeader header;
+    StudentRecord records[LEAF_CAPACITY];
+};
+
+struct InnerPage {
+    NodeHeader header;
+    int32_t keys[INNER_CAPACITY];
+    uint32_t children[INNER_CAPACITY + 1];
+};
+
+static_assert(sizeof(FileHeader) <= PAGE_SIZE, "header must fit in a page");
+static_assert(sizeof(LeafPage) <= PAGE_SIZE, "leaf must fit in a page");
+static_assert(sizeof(InnerPage) <= PAGE_SIZE, "inner node must fit in a page");
+
+// An I/O error leaves the file in an unknown state; stop rather than guess.
+[[noreturn]] void ioFailure(const char *what) {
+    cerr << "I/O error during " << what << ": " << strerror(errno) << "\n";
+    exit(1);
+}
+
+// --------- Buffer pool ---------
+// A fixed number of page frames allocated once; memory use does not grow
+// with the file. Pages are pinned while in use and only unpinned frames are
+// evicted, chosen by the CLOCK algorithm: each access sets a reference bit,
+// and the clock hand clears bits until it finds a frame whose bit is clear.
+// Dirty frames are written back with pwrite when evicted or flushed.
+class BufferPool {
+private:
+    struct Frame {
+        uint32_t page = 0;
+        int pins = 0;
+        bool used = false;
+        bool dirty = false;
+        bool referenced = false;
+    };
+
+    int m_fd;
+    char *m_memory;
+    vector<Frame> m_frames;
+    unordered_map<uint32_t, size_t> m_pageTable; // page number -> frame
+    size_t m_hand = 0;
+
+    long long m_hits = 0;
+    long long m_reads = 0;
+    long long m_writes = 0;
+    long long m_evictions = 0;
+    long long m_prefetches = 0;
+
+    void writeFrame(size_t index) {
+        Frame &f = m_frames[index];
+        off_t offset = static_cast<off_t>(f.page) * PAGE_SIZE;
+        if (pwrite(m_fd, m_memory + index * PAGE_SIZE, PAGE_SIZE, offset) != static_cast<ssize_t>(PAGE_SIZE)) {
+            ioFailure("page write");
+        }
+        f.dirty = false;
+        m_writes++;
+    }
+
+    // Free frame for a new page, evicting one if necessary.
+    size_t claimFrame() {
+        // Two full sweeps clear every reference bit; a third finding nothing
+        // means every frame is pinned.
+        for (size_t scanned = 0; scanned < m_frames.size() * 3; ++scanned) {
+            size_t index = m_hand;
+            m_hand = (m_hand + 1) % m_frames.size();
+            Frame &f = m_frames[index];
+            if (!f.used) return index;
+            if (f.pins > 0) continue;
+            if (f.referenced) {
+                f.referenced = false;
+                continue;
+            }
+            if (f.dirty) writeFrame(index);
+            m_pageTable.erase(f.page);
+            f.used = false;
+            m_evictions++;
+            return index;
+        }
+        cerr << "Buffer pool exhausted: all " << m_frames.size() << " pages are pinned.\n";
+        exit(1);
+    }
+
+    char *install(uint32_t page, size_t index) {
+        Frame &f = m_frames[index];
+        f.page = page;
+        f.pins = 1;
+        f.used = true;
+        f.dirty = false;
+        f.referenced = true;
+        m_pageTable[page] = index;
+        return m_memory + index * PAGE_SIZE;
+    }
+
+public:
+    BufferPool(int fd, size_t frames) : m_fd(fd), m_frames(frames) {
+        m_memory = static_cast<char *>(aligned_alloc(PAGE_SIZE, frames * PAGE_SIZE));
+        if (m_memory == nullptr) {
+            cerr << "Could not allocate " << frames << " buffer pool pages.\n";
+            exit(1);
+        }
+        m_pageTable.reserve(frames);
+    }
+
+    ~BufferPool() {
+        flush();
+        free(m_memory);
+    }
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    // Pin a page, reading it from the file if it is not cached.
+    char *pin(uint32_t page) {
+        auto it = m_pageTable.find(page);
+        if (it != m_pageTable.end()) {
+            Frame &f = m_frames[it->second];
+            f.pins++;
+            f.referenced = true;
+            m_hits++;
+            return m_memory + it->second * PAGE_SIZE;
+        }
+
+        size_t index = claimFrame();
+        char *data = m_memory + index * PAGE_SIZE;
+        off_t offset = static_cast<off_t>(page) * PAGE_SIZE;
+        if (pread(m_fd, data, PAGE_SIZE, offset) != static_cast<ssize_t>(PAGE_SIZE)) {
+            ioFailure("page read");
+        }
+        m_reads++;
+        return install(page, index);
+    }
+
+    // Pin a page that has never been written; its contents start zeroed.
+    char *pinNew(uint32_t page) {
+        size_t index = claimFrame();
+        char *data = install(page, index);
+        memset(data, 0, PAGE_SIZE);
+        m_frames[index].dirty = true;
+        return data;
+    }
+
+    void unpin(uint32_t page, bool dirty) {
+        Frame &f = m_frames[m_pageTable.at(page)];
+        f.pins--;
+        if (dirty) f.dirty = true;
+    }
+
+    // Ask the kernel to start reading a page we will need soon, so the
+    // later pread finds it in the page cache instead of waiting on the disk.
+    void prefetch(uint32_t page) {
+        if (m_pageTable.count(page) != 0) return;
+        posix_fadvise(m_fd, static_cast<off_t>(page) * PAGE_SIZE, PAGE_SIZE, POSIX_FADV_WILLNEED);
+        m_prefetches++;
+    }
+
+    void flush() {
+        for (size_t i = 0; i < m_frames.size(); ++i) {
+            if (m_frames[i].used && m_frames[i].dirty) writeFrame(i);
+        }
+    }
+
+    size_t frames() const { return m_frames.size(); }
+
+    void printStats() const {
+        long long accesses = m_hits + m_reads;
+        cout << "Buffer pool : " << m_frames.size() << " pages ("
+             << m_frames.size() * PAGE_SIZE / 1024 << " KiB), "
+             << m_pageTable.size() << " in use\n";
+        cout << "Hits        : " << m_hits;
+        if (accesses > 0) cout << " (" << 100.0 * m_hits / accesses << "%)";
+        cout << "\n";
+        cout << "Page reads  : " << m_reads << "\n";
+        cout << "Page writes : " << m_writes << "\n";
+        cout << "Evictions   : " << m_evictions << "\n";
+        cout << "Prefetches  : " << m_prefetches << "\n";
+    }
+};
+
+// Pins a page for the lifetime of the handle.
+class PageHandle {
+private:
+    BufferPool &m_pool;
+    uint32_t m_page;
+    char *m_data;
+    bool m_dirty = false;
+
+public:
+    PageHandle(BufferPool &pool, uint32_t page) : m_pool(pool), m_page(page), m_data(pool.pin(page)) {}
+    PageHandle(BufferPool &pool, uint32_t page, bool fresh)
+        : m_pool(pool), m_page(page), m_data(fresh ? pool.pinNew(page) : pool.pin(page)) {}
+    ~PageHandle() { m_pool.unpin(m_page, m_dirty); }
+
+    PageHandle(const PageHandle &) = delete;
+    PageHandle &operator=(const PageHandle &) = delete;
+
+    uint32_t page() const { return m_page; }
+    void markDirty() { m_dirty = true; }
+
+    NodeHeader &node() { return *reinterpret_cast<NodeHeader *>(m_data); }
+    LeafPage &leaf() { return *reinterpret_cast<LeafPage *>(m_data); }
+    InnerPage &inner() { return *reinterpret_cast<InnerPage *>(m_data); }
+};
+
+// --------- Disk-resident B+tree ---------
+// Students live in a single file of 4 KiB pages. Only the buffer pool's
+// frames are held in memory, so an archive far larger than RAM can be
+// searched, extended and updated.
+class PagedBTree {
+private:
+    int m_fd = -1;
+    FileHeader m_header;
+    BufferPool *m_pool = nullptr;
+
+    static const size_t PREFETCH_DEPTH = 8; // leaves requested ahead of a range scan
+
+    uint32_t allocatePage() { return m_header.pageCount++; }
+
+    void writeHeader() {
+        char page[PAGE_SIZE] = {};
+        memcpy(page, &m_header, sizeof(m_header));
+        if (pwrite(m_fd, page, PAGE_SIZE, 0) != static_cast<ssize_t>(PAGE_SIZE)) ioFailure("header write");
+    }
+
+    // Child of an inner node that covers targetId
+    static int childIndex(const InnerPage &inner, int targetId) {
+        return static_cast<int>(upper_bound(inner.keys, inner.keys + inner.header.count, targetId) - inner.keys);
+    }
+
+    // Position of targetId in a leaf, or where it would be inserted
+    static int recordIndex(const LeafPage &leaf, int targetId) {
+        const StudentRecord *end = leaf.records + leaf.header.count;
+        return static_cast<int>(lower_bound(leaf.records, end, targetId,
+                                            [](const StudentRecord &r, int id) { return r.id < id; }) - leaf.records);
+    }
+
+    // Leaf page that may hold targetId
+    uint32_t findLeaf(int targetId, int &steps) {
+        uint32_t page = m_header.root;
+        for (uint32_t level = 1; level < m_header.height; ++level) {
+            PageHandle node(*m_pool, page);
+            page = node.inner().children[childIndex(node.inner(), targetId)];
+            steps++;
+        }
+        return page;
+    }
+
+    // Insert below `page`. When the node splits, the new right sibling and
+    // the smallest key it holds are returned through splitPage/splitKey.
+    bool insertInto(uint32_t page, uint32_t level, const StudentRecord &rec,
+                    bool &duplicate, int &splitKey, uint32_t &splitPage) {
+        PageHandle node(*m_pool, page);
+
+        if (level == m_header.height) {
+            LeafPage &leaf = node.leaf();
+            int pos = recordIndex(leaf, rec.id);
+            if (pos < leaf.header.count && leaf.records[pos].id == rec.id) {
+                duplicate = true;
+                return false;
+            }
+
+            if (leaf.header.count < LEAF_CAPACITY) {
+                memmove(&leaf.records[pos + 1], &leaf.records[pos], (leaf.header.count - pos) * sizeof(StudentRecord));
+                leaf.records[pos] = rec;
+                leaf.header.count++;
+                node.markDirty();
+                return false;
+            }
+
+            // Full: keep the lower half here, move the upper half to a new leaf
+            vector<StudentRecord> all(leaf.records, leaf.records + leaf.header.count);
+            all.insert(all.begin() + pos, rec);
+            size_t keep = all.size() / 2;
+
+            splitPage = allocatePage();
+            PageHandle right(*m_pool, splitPage, true);
+            right.leaf().header.isLeaf = 1;
+            right.leaf().header.count = static_cast<uint16_t>(all.size() - keep);
+            copy(all.begin() + keep, all.end(), right.leaf().records);
+            right.markDirty();
+
+            leaf.header.count = static_cast<uint16_t>(keep);
+            copy(all.begin(), all.begin() + keep, leaf.records);
+            node.markDirty();
+
+            splitKey = all[keep].id;
+            return true;
+        }
+
+        int child = childIndex(node.inner(), rec.id);
+        int childKey = 0;
+        uint32_t childPage = 0;
+        if (!insertInto(node.inner().children[child], level + 1, rec, duplicate, childKey, childPage)) {
+            return false;
+        }
+
+        // The child split: add its new sibling after it
+        InnerPage &inner = node.inner();
+        int count = inner.header.count;
+        if (static_cast<size_t>(count) < INNER_CAPACITY) {
+            memmove(&inner.keys[child + 1], &inner.keys[child], (count - child) * sizeof(int32_t));
+            memmove(&inner.children[child + 2], &inner.children[child + 1], (count - child) * sizeof(uint32_t));
+            inner.keys[child] = childKey;
+            inner.children[child + 1] = childPage;
+            inner.header.count++;
+            node.markDirty();
+            return false;
+        }
+
+        // Full: the middle key moves up, the keys to its right go to a new node
+        vector<int32_t> keys(inner.keys, inner.keys + count);
+        vector<uint32_t> children(inner.children, inner.children + count + 1);
+        keys.insert(keys.begin() + child, childKey);
+        children.insert(children.begin() + child + 1, childPage);
+        size_t middle = keys.size() / 2;
+
+        splitPage = allocatePage();
+        PageHandle right(*m_pool, splitPage, true);
+        InnerPage &sibling = right.inner();
+        sibling.header.isLeaf = 0;
+        sibling.header.count = static_cast<uint16_t>(keys.size() - middle - 1);
+        copy(keys.begin() + middle + 1, keys.end(), sibling.keys);
+        copy(children.begin() + middle + 1, children.end(), sibling.children);
+        right.markDirty();
+
+        inner.header.count = static_cast<uint16_t>(middle);
+        copy(keys.begin(), keys.begin() + middle, inner.keys);
+        copy(children.begin(), children.begin() + middle + 1, inner.children);
+        node.markDirty();
+
+        splitKey = keys[middle];
+        return true;
+    }
+
+    // Step a range scan to the next leaf. `path` holds each inner node on
+    // the way down with the index of the next child to visit. Stops once
+    // the next leaf starts above `limit`.
+    bool nextLeaf(vector<pair<uint32_t, int>> &path, int limit, uint32_t &leaf) {
+        while (!path.empty()) {
+            PageHandle node(*m_pool, path.back().first);
+            const InnerPage &inner = node.inner();
+            int index = path.back().second;
+            if (index > inner.header.count || (index > 0 && inner.keys[index - 1] > limit)) {
+                path.pop_back();
+                continue;
+            }
+            path.back().second++;
+            uint32_t child = inner.children[index];
+            if (path.size() + 1 == m_header.height) {
+                leaf = child;
+                return true;
+            }
+            path.push_back({child, 0});
+        }
+        return false;
+    }
+
+public:
+    PagedBTree() = default;
+    ~PagedBTree() { close(); }
+
+    PagedBTree(const PagedBTree &) = delete;
+    PagedBTree &operator=(const PagedBTree &) = delete;
+
+    // Open or create the file. poolPages bounds the memory used for pages.
+    bool open(const string &path, size_t poolPages) {
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (m_fd < 0) {
+            cout << "Could not open " << path << ": " << strerror(errno) << "\n";
+            return false;
+        }
+
+        char page[PAGE_SIZE];
+        ssize_t got = pread(m_fd, page, PAGE_SIZE, 0);
+        if (got == 0) {
+            // New file: header page plus an empty leaf as the root
+            memcpy(m_header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+            m_header.pageSize = PAGE_SIZE;
+            m_header.root = 1;
+            m_header.pageCount = 2;
+            m_header.height = 1;
+            m_header.studentCount = 0;
+            writeHeader();
+            char empty[PAGE_SIZE] = {};
+            reinterpret_cast<NodeHeader *>(empty)->isLeaf = 1;
+            if (pwrite(m_fd, empty, PAGE_SIZE, PAGE_SIZE) != static_cast<ssize_t>(PAGE_SIZE)) ioFailure("root write");
+        } else {
+            memcpy(&m_header, page, sizeof(m_header));
+            if (got != static_cast<ssize_t>(PAGE_SIZE) || memcmp(m_header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+                m_header.pageSize != PAGE_SIZE) {
+                cout << path << " is not a student archive.\n";
+                ::close(m_fd);
+                m_fd = -1;
+                return false;
+            }
+        }
+
+        // Every level of the tree is pinned during an insert, plus two new pages
+        m_pool = new BufferPool(m_fd, max<size_t>(poolPages, 16));
+        return true;
+    }
+
+    // Write back every dirty page and the header.
+    void flush() {
+        if (m_fd < 0) return;
+        m_pool->flush();
+        writeHeader();
+        fdatasync(m_fd);
+    }
+
+    void close() {
+        if (m_fd < 0) return;
+        flush();
+        delete m_pool;
+        m_pool = nullptr;
+        ::close(m_fd);
+        m_fd = -1;
+    }
+
+    size_t size() const { return m_header.studentCount; }
+    uint32_t height() const { return m_header.height; }
+    uint32_t pages() const { return m_header.pageCount; }
+    BufferPool &pool() { return *m_pool; }
+
+    // Copy the student out of the tree. Steps count the pages visited.
+    bool find(int targetId, Student &out, int &steps) {
+        steps = 0;
+        uint32_t page = findLeaf(targetId, steps);
+        PageHandle node(*m_pool, page);
+        steps++;
+        const LeafPage &leaf = node.leaf();
+        int pos = recordIndex(leaf, targetId);
+        if (pos == leaf.header.count || leaf.records[pos].id != targetId) return false;
+        out = fromRecord(leaf.records[pos]);
+        return true;
+    }
+
+    // Returns false if the ID already exists.
+    bool insert(const Student &s) {
+        StudentRecord rec = toRecord(s);
+        bool duplicate = false;
+        int splitKey = 0;
+        uint32_t splitPage = 0;
+        if (insertInto(m_header.root, 1, rec, duplicate, splitKey, splitPage)) {
+            // The root split: grow the tree by one level
+            uint32_t newRoot = allocatePage();
+            PageHandle root(*m_pool, newRoot, true);
+            InnerPage &inner = root.inner();
+            inner.header.isLeaf = 0;
+            inner.header.count = 1;
+            inner.keys[0] = splitKey;
+            inner.children[0] = m_header.root;
+            inner.children[1] = splitPage;
+            root.markDirty();
+            m_header.root = newRoot;
+            m_header.height++;
+        }
+        if (duplicate) return false;
+        m_header.studentCount++;
+        return true;
+    }
+
+    // Overwrite an existing student's record in place.
+    bool update(const Student &s) {
+        int steps = 0;
+        PageHandle node(*m_pool, findLeaf(s.id, steps));
+        LeafPage &leaf = node.leaf();
+        int pos = recordIndex(leaf, s.id);
+        if (pos == leaf.header.count || leaf.records[pos].id != s.id) return false;
+        leaf.records[pos] = toRecord(s);
+        node.markDirty();
+        return true;
+    }
+
+    // Visit students with low <= ID <= high in order. Leaves are requested
+    // from the kernel a few at a time ahead of the scan so the reads overlap.
+    template <typename Visitor>
+    void forEachInRange(int low, int high, Visitor visit) {
+        vector<pair<uint32_t, int>> path;
+        uint32_t page = m_header.root;
+        for (uint32_t level = 1; level < m_header.height; ++level) {
+            PageHandle node(*m_pool, page);
+            int child = childIndex(node.inner(), low);
+            path.push_back({page, child + 1});
+            page = node.inner().children[child];
+        }
+
+        deque<uint32_t> ahead{page};
+        bool more = true;
+        while (!ahead.empty()) {
+            while (more && ahead.size() < PREFETCH_DEPTH) {
+                uint32_t next = 0;
+                if (nextLeaf(path, high, next)) {
+                    m_pool->prefetch(next);
+                    ahead.push_back(next);
+                } else {
+                    more = false;
+                }
+            }
+
+            PageHandle node(*m_pool, ahead.front());
+            ahead.pop_front();
+            const LeafPage &leaf = node.leaf();
+            for (int i = recordIndex(leaf, low); i < leaf.header.count; ++i) {
+                if (leaf.records[i].id > high) return;
+                visit(fromRecord(leaf.records[i]));
+            }
+        }
+    }
+};
+
+// --------- Helper: safely read an integer ---------
+int readInt(const string &prompt) {
+    int value;
+    while (true) {
+        cout << prompt;
+        if (cin >> value) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
+            return value;
+        } else {
+            cout << "Wrong input, please enter another input (integer).\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+}
+
+// --------- Helper: safely read a double ---------
+double readDouble(const string &prompt) {
+    double value;
+    while (true) {
+        cout << prompt;
+        if (cin >> value) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
+            return value;
+        } else {
+            cout << "Wrong input, please enter another input (number).\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+}
+
+// --------- Helper: read a line that fits in a fixed-size record field ---------
+string readField(const string &prompt, size_t capacity) {
+    string line;
+    while (true) {
+        cout << prompt;
+        getline(cin, line);
+        if (line.size() < capacity) return line;
+        cout << "Too long, please use at most " << capacity - 1 << " characters.\n";
+    }
+}
+
+// --------- Show a single student's info ---------
+void showStudent(const Student &s) {
+    cout << "\n=== Student Information ===\n";
+    cout << "ID     : " << s.id << "\n";
+    cout << "Name   : " << s.name << "\n";
+    cout << "Course : " << s.course << "\n";
+    cout << "Subjects and Marks:\n";
+
+    if (s.subjects.empty()) {
+        cout << "  (No subjects registered)\n";
+    } else {
+        for (size_t i = 0; i < s.subjects.size(); ++i) {
+            cout << "  " << (i + 1) << ". " << s.subjects[i].name << " - ";
+            if (s.subjects[i].hasMark) {
+                cout << s.subjects[i].mark;
+            } else {
+                cout << "(no mark yet)";
+            }
+            cout << "\n";
+        }
+    }
+
+    cout << "===========================\n";
+}
+
+// --------- Menu display ---------
+void showMenu() {
+    cout << "\n==============================\n";
+    cout << "  Student ID Search System\n";
+    cout << "  (Disk-Resident B+Tree)\n";
+    cout << "==============================\n";
+    cout << "1. Enter new student\n";
+    cout << "2. Search student by ID\n";
+    cout << "3. Insert marks\n";
+    cout << "4. List students in an ID range\n";
+    cout << "5. Generate test archive\n";
+    cout << "6. Archive and buffer pool statistics\n";
+    cout << "7. Exit\n";
+    cout << "Enter your choice: ";
+}
+
+// --------- Option 1: Enter new student (with many subjects) ---------
+void menuEnterNewStudent(PagedBTree &students) {
+    while (true) {
+        Student s;
+
+        cout << "\n--- Enter New Student ---\n";
+        s.id = readInt("Enter student ID (integer): ");
+        s.name = readField("Enter name   : ", NAME_CAPACITY);
+        s.course = readField("Enter course : ", COURSE_CAPACITY);
+
+        // Enter multiple subjects
+        cout << "\nNow enter subjects for this student (at most " << MAX_SUBJECTS << ").\n";
+        cout << "Press \"Enter\" to add new subject or press \"0\" when you are done.\n";
+
+        while (s.subjects.size() < MAX_SUBJECTS) {
+            SubjectRecord sub;
+            sub.name = readField("Enter subject name (or 0 to finish): ", SUBJECT_NAME_CAPACITY);
+
+            if (sub.name == "0") {
+                if (s.subjects.empty()) {
+                    cout << "Student must have at least one subject.\n";
+                    continue;
+                } else {
+                    break;
+                }
+            }
+
+            sub.hasMark = false;
+            sub.mark = 0.0;
+            s.subjects.push_back(sub);
+        }
+
+        if (students.insert(s)) {
+            cout << "Student with ID " << s.id << " has been added successfully.\n";
+        } else {
+            cout << "ID " << s.id << " already exists in the system.\n";
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Enter another student\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                // loop again to add another student
+                break;
+            } else if (choice == 2) {
+                return; // back to main menu
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 2: Search student by ID ---------
+void menuSearchStudent(PagedBTree &students) {
+    if (students.size() == 0) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Search Student by ID ---\n";
+        int targetId = readInt("Enter student ID to search: ");
+        int steps = 0; // Initialize steps counter
+
+        Student s;
+        if (students.find(targetId, s, steps)) {
+            showStudent(s);
+            cout << "Pages visited to find the student: " << steps << "\n";
+        } else {
+            cout << "ID " << targetId << " not found in the system.\n";
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Search another ID\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                // loop again to search another ID
+                break;
+            } else if (choice == 2) {
+                return; // back to main menu
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 3: Insert marks for subjects ---------
+void menuInsertMarks(PagedBTree &students) {
+    if (students.size() == 0) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    while (true) {
+        cout << "\n--- Insert Marks ---\n";
+        int targetId = readInt("Enter student ID to insert marks: ");
+
+        int steps = 0;
+        Student s;
+        if (!students.find(targetId, s, steps)) {
+            cout << "ID " << targetId << " not found in the system.\n";
+        } else {
+            cout << "\nInserting marks for student:\n";
+            showStudent(s);
+            cout << "\nEnter marks for each subject.\n";
+
+            for (size_t i = 0; i < s.subjects.size(); ++i) {
+                cout << "\nSubject " << (i + 1) << ": " << s.subjects[i].name << "\n";
+                double mark = readDouble("Enter mark: ");
+                s.subjects[i].mark = mark;
+                s.subjects[i].hasMark = true;
+            }
+
+            students.update(s);
+            cout << "\nAll marks updated for this student.\n";
+            showStudent(s);
+        }
+
+        // Ask user what next
+        while (true) {
+            int choice = readInt(
+                "\nWhat do you want to do next?\n"
+                "1. Insert marks for another ID\n"
+                "2. Return to main menu\n"
+                "Enter your choice: "
+            );
+
+            if (choice == 1) {
+                break; // loop again
+            } else if (choice == 2) {
+                return;
+            } else {
+                cout << "Wrong input, please enter another input (1 or 2).\n";
+            }
+        }
+    }
+}
+
+// --------- Option 4: List students in an ID range ---------
+void menuRangeScan(PagedBTree &students) {
+    if (students.size() == 0) {
+        cout << "\nNo students in the system yet. Please add some first.\n";
+        return;
+    }
+
+    cout << "\n--- List Students in an ID Range ---\n";
+    int low = readInt("Enter lowest ID : ");
+    int high = readInt("Enter highest ID: ");
+
+    size_t count = 0;
+    auto start = chrono::steady_clock::now();
+    students.forEachInRange(low, high, [&](const Student &s) {
+        if (count < 20) cout << "  " << s.id << "  " << s.name << "  (" << s.course << ")\n";
+        count++;
+    });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (count > 20) cout << "  ... " << count - 20 << " more\n";
+    cout << count << " students in range, scanned in " << seconds * 1000.0 << " ms\n";
+}
+
+// --------- Option 5: Fill the archive with random students ---------
+void menuGenerateArchive(PagedBTree &students) {
+    int count = readInt("\nHow many random students to add: ");
+    if (count <= 0) {
+        cout << "Nothing to add.\n";
+        return;
+    }
+
+    mt19937 rng(12345 + static_cast<unsigned>(students.size()));
+    const char *subjects[] = {"Mathematics", "Physics", "Chemistry", "History"};
+    int added = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        Student s;
+        s.id = static_cast<int>(rng() % 2000000000);
+        s.name = "Alumnus " + to_string(s.id);
+        s.course = "Archive";
+        for (const char *name : subjects) {
+            s.subjects.push_back(SubjectRecord{name, static_cast<double>(rng() % 101), true});
+        }
+        if (students.insert(s)) added++;
+    }
+    students.flush();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << added << " students added in " << seconds * 1000.0 << " ms ("
+         << students.size() << " in the archive)\n";
+}
+
+// --------- Option 6: Archive and buffer pool statistics ---------
+void menuStatistics(PagedBTree &students) {
+    cout << "\n--- Archive Statistics ---\n";
+    cout << "Students    : " << students.size() << "\n";
+    cout << "Tree height : " << students.height() << "\n";
+    cout << "File size   : " << static_cast<double>(students.pages()) * PAGE_SIZE / (1024.0 * 1024.0) << " MiB ("
+         << students.pages() << " pages, " << LEAF_CAPACITY << " students per leaf)\n";
+    students.pool().printStats();
+}
+
+// --------- main ---------
+// Usage: paged_btree [archive file] [--pool-pages=N]
+int main(int argc, char *argv[]) {
+    string path = "students.db";
+    size_t poolPages = 256; // 1 MiB of page frames
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--pool-pages=", 0) == 0) {
+            poolPages = strtoul(arg.c_str() + 13, nullptr, 10);
+        } else {
+            path = arg;
+        }
+    }
+
+    PagedBTree students;
+    if (!students.open(path, poolPages)) return 1;
+    cout << "Archive " << path << ": " << students.size() << " students, buffer pool of "
+         << students.pool().frames() << " pages\n";
+
+    int choice;
+
+    while (true) {
+        showMenu();
+
+        if (!(cin >> choice)) {
+            cout << "Wrong input, please enter another input (1–7).\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n'); // clear newline
+
+        switch (choice) {
+            case 1:
+                menuEnterNewStudent(students);
+                break;
+            case 2:
+                menuSearchStudent(students);
+                break;
+            case 3:
+                menuInsertMarks(students);
+                break;
+            case 4:
+                menuRangeScan(students);
+                break;
+            case 5:
+                menuGenerateArchive(students);
+                break;
+            case 6:
+                menuStatistics(students);
+                break;
+            case 7:
+                cout << "\nExiting program. Goodbye!\n";
+                return 0;
+            default:
+                cout << "Wrong input, please enter another input (1–7).\n";
+                break;
+        }
+    }
+
+    return 0;
+}